@@ -0,0 +1,67 @@
+#ifndef COMMAND_LINE_FLAGS
+#define COMMAND_LINE_FLAGS
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define PROTOCOL_FLAG "--protocol="
+#define CRYPTO_FLAG "--crypto="
+
+// Selects the key agreement protocol and crypto algorithm of a run with --protocol=<name> and --crypto=<name>,
+// which may appear anywhere in the arguments. The remaining arguments keep their positions for the caller.
+class command_line_flags {
+// Variables
+public:
+    static inline const std::vector<std::string> protocols_ = {"PROTO_STR_DH", "PROTO_DST_DH", "PROTO_TGDH"};
+    static inline const std::vector<std::string> crypto_algorithms_ = {"ECC_DH", "DEFAULT_DH", "X25519_DH"};
+private:
+    std::string protocol_ = "PROTO_STR_DH";
+    std::string crypto_algorithm_ = "ECC_DH";
+    std::vector<char*> positional_arguments_;
+    bool valid_ = true;
+// Methods
+public:
+    command_line_flags(int _argc, char* _argv[]) {
+        for (int i = 0; i < _argc; i++) {
+            std::string argument(_argv[i]);
+            if (argument.starts_with(PROTOCOL_FLAG)) {
+                protocol_ = argument.substr(std::string(PROTOCOL_FLAG).size());
+                valid_ = valid_ && std::find(protocols_.begin(), protocols_.end(), protocol_) != protocols_.end();
+            } else if (argument.starts_with(CRYPTO_FLAG)) {
+                crypto_algorithm_ = argument.substr(std::string(CRYPTO_FLAG).size());
+                valid_ = valid_ && std::find(crypto_algorithms_.begin(), crypto_algorithms_.end(), crypto_algorithm_) != crypto_algorithms_.end();
+            } else {
+                positional_arguments_.push_back(_argv[i]);
+            }
+        }
+        positional_arguments_.push_back(nullptr);
+    }
+
+    const std::string& get_protocol() const {
+        return protocol_;
+    }
+
+    const std::string& get_crypto_algorithm() const {
+        return crypto_algorithm_;
+    }
+
+    // argc and argv without the flags
+    int get_argc() const {
+        return positional_arguments_.size() - 1;
+    }
+
+    char** get_argv() {
+        return positional_arguments_.data();
+    }
+
+    bool is_valid() const {
+        return valid_;
+    }
+
+    static std::string usage() {
+        return "[--protocol=PROTO_STR_DH|PROTO_DST_DH|PROTO_TGDH] [--crypto=ECC_DH|DEFAULT_DH|X25519_DH]";
+    }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "key_agreement_protocol.hpp"
+#include "message_handler.hpp"
+#include "primitives.hpp"
+
+// Checks that deserialize_and_callback decodes every message type as views into the datagram and dispatches it to
+// its process_* method without a single heap allocation. Blobs are sized after the blinded secrets of X25519_DH,
+// compressed and uncompressed secp256r1 and MODP2048. Returns 1 if any message type allocates or is not dispatched.
+
+static std::atomic<size_t> allocation_count(0);
+
+void* operator new(size_t _size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(_size ? _size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* _pointer) noexcept {
+    std::free(_pointer);
+}
+
+void operator delete(void* _pointer, size_t) noexcept {
+    std::free(_pointer);
+}
+
+class decode_allocation_test : public key_agreement_protocol {
+    public:
+        typedef handled_messages<find_message, offer_message, request_message, response_message, member_info_request_message, member_info_response_message,
+                                 synch_token_message, member_info_synch_request_message, member_info_synch_response_message, distributed_response_message,
+                                 finish_message, finish_ack_message, blinded_key_message> handled_messages_t;
+
+        decode_allocation_test() : message_handler_(std::make_unique<message_handler<decode_allocation_test>>(this)), dispatched_count_(0), failed_(false) {
+            for (member_id_t member_id = 1; member_id <= 100; member_id++) {
+                requested_members_.insert(member_id);
+            }
+        }
+
+        void run(size_t _blob_length) {
+            std::vector<unsigned char> bytes(_blob_length, 0x5A);
+            byte_view_t blob(bytes);
+
+            find_message find;
+            find.required_service_ = DEFAULT_SERVICE_ID;
+            check(_blob_length, "find", find);
+
+            offer_message offer;
+            offer.offered_service_ = DEFAULT_SERVICE_ID;
+            check(_blob_length, "offer", offer);
+
+            request_message request;
+            request.required_service_ = DEFAULT_SERVICE_ID;
+            request.blinded_secret_ = blob;
+            check(_blob_length, "request", request);
+
+            response_message response;
+            response.offered_service_ = DEFAULT_SERVICE_ID;
+            response.blinded_sponsor_secret_ = blob;
+            response.blinded_group_secret_ = blob;
+            response.new_sponsor.endpoint_ = boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), 65000);
+            response.new_sponsor.assigned_id_ = 1;
+            response.new_sponsor.blinded_secret_ = blob;
+            check(_blob_length, "response", response);
+
+            member_info_request_message member_info_request;
+            member_info_request.required_service_ = DEFAULT_SERVICE_ID;
+            member_info_request.requested_members_ = requested_members_;
+            check(_blob_length, "member_info_request", member_info_request);
+
+            member_info_response_message member_info_response;
+            member_info_response.offered_service_ = DEFAULT_SERVICE_ID;
+            member_info_response.member_id_ = 1;
+            member_info_response.blinded_secret_ = blob;
+            check(_blob_length, "member_info_response", member_info_response);
+
+            synch_token_message synch_token;
+            synch_token.member_id_ = 1;
+            check(_blob_length, "synch_token", synch_token);
+
+            member_info_synch_request_message member_info_synch_request;
+            member_info_synch_request.required_service_ = DEFAULT_SERVICE_ID;
+            member_info_synch_request.requested_members_ = requested_members_;
+            check(_blob_length, "member_info_synch_request", member_info_synch_request);
+
+            member_info_synch_response_message member_info_synch_response;
+            member_info_synch_response.offered_service_ = DEFAULT_SERVICE_ID;
+            member_info_synch_response.member_id_ = 1;
+            member_info_synch_response.blinded_secret_ = blob;
+            check(_blob_length, "member_info_synch_response", member_info_synch_response);
+
+            distributed_response_message distributed_response;
+            distributed_response.offered_service_ = DEFAULT_SERVICE_ID;
+            distributed_response.blinded_sponsor_secret_ = blob;
+            distributed_response.encrypted_group_secret_ = blob;
+            distributed_response.initialization_vector_ = blob;
+            check(_blob_length, "distributed_response", distributed_response);
+
+            finish_message finish;
+            check(_blob_length, "finish", finish);
+
+            finish_ack_message finish_ack;
+            check(_blob_length, "finish_ack", finish_ack);
+
+            blinded_key_message blinded_key;
+            blinded_key.offered_service_ = DEFAULT_SERVICE_ID;
+            blinded_key.node_id_ = 2;
+            blinded_key.blinded_key_ = blob;
+            check(_blob_length, "blinded_key", blinded_key);
+        }
+
+        bool succeeded() const {
+            return !failed_;
+        }
+
+        void process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_response(const response_message& _rcvd_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_member_info_request(const member_info_request_message& _rcvd_member_info_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_member_info_response(const member_info_response_message& _rcvd_member_info_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_synch_token(const synch_token_message& _rcvd_synch_token_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_member_info_synch_request(const member_info_synch_request_message& _rcvd_member_info_synch_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_member_info_synch_response(const member_info_synch_response_message& _rcvd_member_info_synch_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_distributed_response(const distributed_response_message& _rcvd_distributed_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+        void process_blinded_key(const blinded_key_message& _rcvd_blinded_key_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { dispatched(); }
+    private:
+        enum { iterations = 1000 };
+        std::unique_ptr<message_handler<decode_allocation_test>> message_handler_;
+        wire_bitmap<member_id_t> requested_members_;
+        boost::asio::ip::udp::endpoint remote_endpoint_;
+        size_t dispatched_count_;
+        bool failed_;
+
+        void dispatched() {
+            dispatched_count_++;
+        }
+
+        void check(size_t _blob_length, const std::string& _message_name, const message& _message) {
+            std::vector<unsigned char> datagram;
+            message_handler_->serialize(_message, datagram);
+            byte_view_t datagram_view(datagram);
+            // Warm up, so one-time initialization is not counted
+            message_handler_->deserialize_and_callback(datagram_view, remote_endpoint_);
+
+            size_t dispatched_before = dispatched_count_;
+            size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < iterations; i++) {
+                message_handler_->deserialize_and_callback(datagram_view, remote_endpoint_);
+            }
+            size_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+            if (allocations != 0 || dispatched_count_ - dispatched_before != iterations) {
+                failed_ = true;
+                std::cerr << "[<decode_allocation_test>]: " << _message_name << " with " << _blob_length << " byte blobs: " << allocations << " allocations, "
+                          << dispatched_count_ - dispatched_before << " of " << iterations << " dispatched" << std::endl;
+            }
+        }
+};
+
+int main(int argc, char* argv[]) {
+    decode_allocation_test test;
+    for (size_t blob_length : {32, 33, 65, 256}) {
+        test.run(blob_length);
+    }
+    if (!test.succeeded()) {
+        return 1;
+    }
+    std::cout << "[<decode_allocation_test>]: Every message type is decoded and dispatched without allocations" << std::endl;
+    return 0;
+}
@@ -3,7 +3,7 @@
 
 #include <cryptopp/integer.h>
 
-CryptoPP::Integer P(
+inline CryptoPP::Integer P(
     "0x87A8E61DB4B6663CFFBBD19C651959998CEEF608660DD0F2"
     "5D2CEED4435E3B00E00DF8F1D61957D4FAF7DF4561B2AA30"
     "16C3D91134096FAA3BF4296D830E9A7C209E0C6497517ABD"
@@ -16,7 +16,7 @@ CryptoPP::Integer P(
     "75F26375D7014103A4B54330C198AF126116D2276E11715F"
     "693877FAD7EF09CADB094AE91E1A1597");
 
-CryptoPP::Integer G(
+inline CryptoPP::Integer G(
     "0x3FB32C9B73134D0B2E77506660EDBD484CA7B18F21EF2054"
     "07F4793A1A0BA12510DBC15077BE463FFF4FED4AAC0BB555"
     "BE3A6C1B0C6B47B1BC3773BF7E8C6F62901228F8C28CBB18"
@@ -29,6 +29,6 @@ CryptoPP::Integer G(
     "184B523D1DB246C32F63078490F00EF8D647D148D4795451"
     "5E2327CFEF98C582664B4C0F6CC41659");
 
-CryptoPP::Integer Q("0x8CF83642A709A097B447997640129DA299B1A47D1EB3750BA308B0FE64F5FBD3");
+inline CryptoPP::Integer Q("0x8CF83642A709A097B447997640129DA299B1A47D1EB3750BA308B0FE64F5FBD3");
 
 #endif
\ No newline at end of file
@@ -1,31 +1,36 @@
 #include "distributed_dh.hpp"
-#include "MODP2048_256sg.hpp"
 
 #include <unistd.h>
 #include <random>
+#include <sstream>
 #include <cryptopp/nbtheory.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/oids.h>
 #include <cryptopp/asn.h>
 
-distributed_dh::distributed_dh(bool _is_sponsor, service_id_t _service_id,  std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port) : is_sponsor_(_is_sponsor), service_of_interest_(_service_id), member_count_(_member_count), multicast_application_impl(_listening_interface_by_ip, _multicast_ip, _multicast_port), message_handler_(std::make_unique<message_handler>(this)), statistics_recorder_(statistics_recorder::get_instance()), scatter_timer_(multicast_application_impl::get_io_service()), timeout_timer_(multicast_application_impl::get_io_service()) {
+template <typename group_t>
+distributed_dh<group_t>::distributed_dh(bool _is_sponsor, service_id_t _service_id,  std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count, std::uint32_t _send_rate, in_memory_bus* _in_memory_bus) : is_sponsor_(_is_sponsor), service_of_interest_(_service_id), member_count_(_member_count), multicast_application_impl(_listening_interface_by_ip, _multicast_ip, _multicast_port, _worker_thread_count, _send_rate, _in_memory_bus), message_handler_(std::make_unique<message_handler<distributed_dh>>(this)), statistics_recorder_(_in_memory_bus ? statistics_recorder::create_instance() : statistics_recorder::get_instance()), scatter_timer_(multicast_application_impl::get_strand()), timeout_timer_(multicast_application_impl::get_strand()) {
     if (is_sponsor_) {
         statistics_recorder_->record_timestamp(time_metric::DURATION_START_);
     }
 #ifdef RETRANSMISSIONS
     scatter_delay_ = compute_scatter_delay(_scatter_delay_min, _scatter_delay_max);
 #endif
-#ifdef DEFAULT_DH
-    diffie_hellman_.AccessGroupParameters().Initialize(P, Q, G);
-    LOG_DEBUG("[<distributed_dh>]: Using default DH")
-#elif defined(ECC_DH)
-    diffie_hellman_.AccessGroupParameters().Initialize(CryptoPP::ASN1::secp256r1());
-    LOG_DEBUG("[<distributed_dh>]: Using ECDH")
-#endif
-    secret_.New(diffie_hellman_.PrivateKeyLength());
-    blinded_secret_.New(diffie_hellman_.PublicKeyLength());
-    diffie_hellman_.GeneratePrivateKey(rnd_, secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
-    diffie_hellman_.GeneratePublicKey(rnd_, secret_, blinded_secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    group_t::initialize(diffie_hellman_);
+    point_codec_.initialize(diffie_hellman_);
+    LOG_DEBUG("[<distributed_dh>]: Using " << group_t::name_)
+    // Members of an in-memory simulation pull key pairs that were generated in the background while the members before them were constructed
+    key_pair_pool<typename group_t::domain_t>* pregenerated_key_pairs = _in_memory_bus ? key_pair_pool<typename group_t::domain_t>::get_instance(diffie_hellman_, member_count_ + 1, _worker_thread_count) : nullptr;
+    if (!pregenerated_key_pairs || !pregenerated_key_pairs->pull(secret_, blinded_secret_)) {
+        secret_.New(diffie_hellman_.PrivateKeyLength());
+        blinded_secret_.New(diffie_hellman_.PublicKeyLength());
+        diffie_hellman_.GeneratePrivateKey(rnd_, secret_);
+        diffie_hellman_.GeneratePublicKey(rnd_, secret_, blinded_secret_);
+    }
+    // Pulled pairs are counted as well, they were generated for this member
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    wire_blinded_secret_ = point_codec_.to_wire(blinded_secret_);
 
     non_acked_responses_.clear();
     endpoints_acks_rcvd_from_.clear();
@@ -33,94 +38,167 @@ distributed_dh::distributed_dh(bool _is_sponsor, service_id_t _service_id,  std:
     statistics_recorder_->record_count(count_metric::MEMBER_COUNT_);
 
     if (is_sponsor_) {
-        group_secret_.New(diffie_hellman_.AgreedValueLength());
-        diffie_hellman_.GeneratePrivateKey(rnd_, group_secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+        group_secret_.CleanNew(diffie_hellman_.AgreedValueLength());
+        secret_t pooled_group_secret;
+        blinded_secret_t unused_blinded_group_secret;
+        // The group secret is a private key as well, the pool pair's public half is not needed
+        if (pregenerated_key_pairs && pregenerated_key_pairs->pull(pooled_group_secret, unused_blinded_group_secret)) {
+            std::copy(pooled_group_secret.begin(), pooled_group_secret.end(), group_secret_.begin());
+        } else {
+            diffie_hellman_.GeneratePrivateKey(rnd_, group_secret_);
+        }
+        statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
 
         LOG_STD("[<distributed_dh>]: pid=" << getpid() << " generated group secret " << short_secret_repr(group_secret_))
 
-        std::unique_ptr<offer_message> initial_offer = std::make_unique<offer_message>();
-        initial_offer->offered_service_ = service_of_interest_;
-        send_multicast(initial_offer.operator*()); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+        offer_message initial_offer;
+        initial_offer.offered_service_ = service_of_interest_;
+        send_multicast(initial_offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
 #ifdef RETRANSMISSIONS
         send_cyclic_messages();
 #endif
     } else {
-        // std::unique_ptr<find_message> initial_find = std::make_unique<find_message>();
-        // initial_find->required_service_ = service_of_interest_;
-        // send_multicast(initial_find.operator*()); statistics_recorder_->record_count(count_metric::FIND_MESSAGE_COUNT_);
+        // find_message initial_find;
+        // initial_find.required_service_ = service_of_interest_;
+        // send_multicast(initial_find); statistics_recorder_->record_count(count_metric::FIND_MESSAGE_COUNT_);
     }
 }
 
-distributed_dh::~distributed_dh() {
+template <typename group_t>
+distributed_dh<group_t>::~distributed_dh() {
 
 }
 
-void distributed_dh::start() {
+template <typename group_t>
+void distributed_dh<group_t>::start() {
     multicast_application_impl::start();
 }
 
-void distributed_dh::received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    std::lock_guard<std::mutex> lock_receive(receive_mutex_);
+template <typename group_t>
+void distributed_dh<group_t>::received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) {
+    // Runs on the strand, so no further locking of the protocol state is needed
     if (get_local_endpoint().port() != _remote_endpoint.port()) {
-        message_handler_->deserialize_and_callback(_data, _bytes_recvd, _remote_endpoint);
+        message_handler_->deserialize_and_callback(byte_view_t(_data, _bytes_recvd), _remote_endpoint);
     }
 }
 
-void distributed_dh::process_find(find_message _rcvd_find_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+bool distributed_dh<group_t>::is_relevant(const message_header& _header) {
+    if (_header.service_id_ != ANY_SERVICE_ID && _header.service_id_ != service_of_interest_) {
+        return false;
+    }
+    switch (_header.message_type_) {
+        case message_type::REQUEST:
+            // Only the sponsor answers requests
+            return is_sponsor_;
+        case message_type::OFFER:
+            // Offers are only answered until the group secret is received
+            return !group_secret_rcvd();
+        default:
+            return true;
+    }
+}
+
+template <typename group_t>
+void distributed_dh<group_t>::process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (is_sponsor_ && service_of_interest_ == _rcvd_find_message.required_service_) {
-        std::unique_ptr<offer_message> offer = std::make_unique<offer_message>();
-        offer->offered_service_ = service_of_interest_;
-        send_multicast(offer.operator*()); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+        offer_message offer;
+        offer.offered_service_ = service_of_interest_;
+        send_multicast(offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
     }
 }
 
-void distributed_dh::process_offer(offer_message _rcvd_offer_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void distributed_dh<group_t>::process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (!group_secret_rcvd() && _rcvd_offer_message.offered_service_ == service_of_interest_) {
-        std::unique_ptr<request_message> request = std::make_unique<request_message>();
-        request->blinded_secret_ = blinded_secret_;
-        request->required_service_ = service_of_interest_;
-        send_to(request.operator*(), _remote_endpoint); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
+        request_message request;
+        request.blinded_secret_ = wire_blinded_secret_;
+        request.required_service_ = service_of_interest_;
+        send_to(request, _remote_endpoint); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
     }
 }
 
-void distributed_dh::process_request(request_message _rcvd_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    if (non_acked_responses_.size() + endpoints_acks_rcvd_from_.size() == 0) { statistics_recorder_->record_timestamp(time_metric::KEY_AGREEMENT_START_); }
-    if (!non_acked_responses_.count(_remote_endpoint) && _rcvd_request_message.required_service_ == service_of_interest_) {
-        secret_t shared_secret(diffie_hellman_.AgreedValueLength());
-        diffie_hellman_.Agree(shared_secret, secret_, _rcvd_request_message.blinded_secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
-
-        // Calculate a SHA-256 hash over the Diffie-Hellman session key
-        CryptoPP::SecByteBlock key(CryptoPP::SHA256::DIGESTSIZE);
-        CryptoPP::SHA256().CalculateDigest(key, shared_secret, shared_secret.SizeInBytes()); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
-        // Generate a random IV
+template <typename group_t>
+void distributed_dh<group_t>::process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (non_acked_responses_.size() + endpoints_acks_rcvd_from_.size() + responses_in_progress_.size() == 0) { statistics_recorder_->record_timestamp(time_metric::KEY_AGREEMENT_START_); }
+    // Decoded on the strand (the point codec is not thread-safe) and checked before it is passed to Crypto++ as a raw pointer
+    blinded_secret_t blinded_member_secret;
+    if (!non_acked_responses_.count(_remote_endpoint) && !responses_in_progress_.count(_remote_endpoint) && _rcvd_request_message.required_service_ == service_of_interest_
+        && (blinded_member_secret = point_codec_.from_wire(_rcvd_request_message.blinded_secret_)).SizeInBytes() == diffie_hellman_.PublicKeyLength()) {
+        responses_in_progress_.insert(_remote_endpoint);
+        // Generate a random IV here, the random pool must not be shared with the worker threads
         CryptoPP::byte iv[CryptoPP::AES::BLOCKSIZE];
         rnd_.GenerateBlock(iv, CryptoPP::AES::BLOCKSIZE);
         std::vector<CryptoPP::byte> iv_vector(iv, iv + CryptoPP::AES::BLOCKSIZE);
 
-        CryptoPP::SecByteBlock encrypted_group_key(group_secret_.SizeInBytes());
+        // Offload the key agreement and encryption to any worker, only the result is applied on the strand
+        boost::asio::post(get_io_service(), [this, blinded_member_secret, iv_vector, _remote_endpoint]() {
+            shared_datagram_t serialized_response = compute_distributed_response(blinded_member_secret, iv_vector);
+            boost::asio::post(get_strand(), [this, serialized_response, _remote_endpoint]() {
+                send_distributed_response(serialized_response, _remote_endpoint);
+            });
+        });
+    }
+}
 
-        // Encrypt
-        CryptoPP::CFB_Mode<CryptoPP::AES>::Encryption cfbEncryption(key, CryptoPP::SHA256::DIGESTSIZE, iv);
-        cfbEncryption.ProcessData(encrypted_group_key.BytePtr(), group_secret_.BytePtr(), group_secret_.SizeInBytes()); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+template <typename group_t>
+shared_datagram_t distributed_dh<group_t>::compute_distributed_response(const blinded_secret_t& _blinded_member_secret, const std::vector<CryptoPP::byte>& _iv_vector) {
+    // Crypto++ domains keep scratch buffers that Agree writes to, so every worker thread agrees on its own domain.
+    // Besides it only reads secret_, wire_blinded_secret_ and group_secret_, which are immutable once the sponsor is constructed
+    static thread_local typename group_t::domain_t worker_diffie_hellman = [] {
+        typename group_t::domain_t diffie_hellman;
+        group_t::initialize(diffie_hellman);
+        return diffie_hellman;
+    }();
+    secret_t shared_secret(worker_diffie_hellman.AgreedValueLength());
+    worker_diffie_hellman.Agree(shared_secret, secret_, _blinded_member_secret);
+
+    // Calculate a SHA-256 hash over the Diffie-Hellman session key
+    CryptoPP::SecByteBlock key(CryptoPP::SHA256::DIGESTSIZE);
+    CryptoPP::SHA256().CalculateDigest(key, shared_secret, shared_secret.SizeInBytes());
+
+    CryptoPP::SecByteBlock encrypted_group_key(group_secret_.SizeInBytes());
+
+    // Encrypt
+    CryptoPP::CFB_Mode<CryptoPP::AES>::Encryption cfbEncryption(key, CryptoPP::SHA256::DIGESTSIZE, _iv_vector.data());
+    cfbEncryption.ProcessData(encrypted_group_key.BytePtr(), group_secret_.BytePtr(), group_secret_.SizeInBytes());
+
+    distributed_response_message distributed_response;
+    distributed_response.offered_service_ = service_of_interest_;
+    distributed_response.blinded_sponsor_secret_ = wire_blinded_secret_;
+    distributed_response.encrypted_group_secret_ = encrypted_group_key;
+    distributed_response.initialization_vector_ = _iv_vector;
+    // Serialize here, the message only borrows encrypted_group_key and _iv_vector (message_handler::serialize is stateless)
+    return serialize(distributed_response);
+}
 
-        std::unique_ptr<distributed_response_message> distributed_response = std::make_unique<distributed_response_message>();
-        distributed_response->offered_service_ = service_of_interest_;
-        distributed_response->blinded_sponsor_secret_ = blinded_secret_;
-        distributed_response->encrypted_group_secret_ = encrypted_group_key;
-        distributed_response->initialization_vector_ = iv_vector;
+template <typename group_t>
+void distributed_dh<group_t>::send_distributed_response(shared_datagram_t _serialized_response, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    // Agree, SHA-256 and AES of compute_distributed_response (statistics_recorder is not thread-safe)
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    responses_in_progress_.erase(_remote_endpoint);
+    if (endpoints_acks_rcvd_from_.count(_remote_endpoint)) {
+        return;
+    }
 
-        non_acked_responses_[_remote_endpoint] = std::make_unique<distributed_response_message>(distributed_response.operator*());
+    non_acked_responses_[_remote_endpoint] = _serialized_response;
 
-        send_to(distributed_response.operator*(), _remote_endpoint); statistics_recorder_->record_count(count_metric::DISTRIBUTED_RESPONSE_MESSAGE_COUNT_);
-    }
+    multicast_application_impl::send_to(_serialized_response, _remote_endpoint); statistics_recorder_->record_count(count_metric::DISTRIBUTED_RESPONSE_MESSAGE_COUNT_);
 }
 
-void distributed_dh::process_distributed_response(distributed_response_message _rcvd_distributed_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    if (!group_secret_rcvd() && _rcvd_distributed_response_message.offered_service_ == service_of_interest_) {
-        CryptoPP::SecByteBlock encrypted_group_secret_ = _rcvd_distributed_response_message.encrypted_group_secret_;
+template <typename group_t>
+void distributed_dh<group_t>::process_distributed_response(const distributed_response_message& _rcvd_distributed_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    // The fields are passed to Crypto++ as raw pointers, so their sizes are checked first
+    blinded_secret_t blinded_sponsor_secret;
+    if (!group_secret_rcvd() && _rcvd_distributed_response_message.offered_service_ == service_of_interest_
+        && (blinded_sponsor_secret = point_codec_.from_wire(_rcvd_distributed_response_message.blinded_sponsor_secret_)).SizeInBytes() == diffie_hellman_.PublicKeyLength()
+        && _rcvd_distributed_response_message.initialization_vector_.size() == CryptoPP::AES::BLOCKSIZE) {
+        byte_view_t encrypted_group_secret = _rcvd_distributed_response_message.encrypted_group_secret_;
 
         secret_t shared_secret(diffie_hellman_.AgreedValueLength());
-        diffie_hellman_.Agree(shared_secret, secret_, _rcvd_distributed_response_message.blinded_sponsor_secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+        diffie_hellman_.Agree(shared_secret, secret_, blinded_sponsor_secret); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
 
         // Calculate a SHA-256 hash over the Diffie-Hellman session key
         CryptoPP::SecByteBlock key(CryptoPP::SHA256::DIGESTSIZE);
@@ -130,7 +208,7 @@ void distributed_dh::process_distributed_response(distributed_response_message _
 
         // Decrypt
         CryptoPP::CFB_Mode<CryptoPP::AES>::Decryption cfbDecryption(key, CryptoPP::SHA256::DIGESTSIZE, _rcvd_distributed_response_message.initialization_vector_.data());
-        cfbDecryption.ProcessData(decrypted_group_key.BytePtr(), encrypted_group_secret_.BytePtr(), encrypted_group_secret_.SizeInBytes()); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+        cfbDecryption.ProcessData(decrypted_group_key.BytePtr(), encrypted_group_secret.data(), encrypted_group_secret.size()); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
 
         group_secret_.New(diffie_hellman_.AgreedValueLength());
         group_secret_ = decrypted_group_key;
@@ -138,26 +216,26 @@ void distributed_dh::process_distributed_response(distributed_response_message _
         LOG_DEBUG("[<distributed_dh>]: pid=" << getpid() << " received group secret " << short_secret_repr(group_secret_))
     }
     if (group_secret_rcvd() && _rcvd_distributed_response_message.offered_service_ == service_of_interest_) {
-        std::unique_ptr<finish_ack_message> finish_ack = std::make_unique<finish_ack_message>();
-        send_to(finish_ack.operator*(), _remote_endpoint); statistics_recorder_->record_count(count_metric::FINISH_ACK_MESSAGE_COUNT_);
+        finish_ack_message finish_ack;
+        send_to(finish_ack, _remote_endpoint); statistics_recorder_->record_count(count_metric::FINISH_ACK_MESSAGE_COUNT_);
 #ifndef RETRANSMISSIONS
         contribute_statistics();
 #endif
     }
 }
 
-void distributed_dh::send_cyclic_messages() {
+template <typename group_t>
+void distributed_dh<group_t>::send_cyclic_messages() {
     scatter_timer_.expires_from_now(scatter_delay_);
     scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
-        if (!_error && (non_acked_responses_.size() + endpoints_acks_rcvd_from_.size() != member_count_-1)) {
-            std::unique_ptr<offer_message> offer = std::make_unique<offer_message>();
-            offer->offered_service_ = service_of_interest_;
-            send_multicast(offer.operator*()); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+        if (!_error && (non_acked_responses_.size() + endpoints_acks_rcvd_from_.size() + responses_in_progress_.size() != member_count_-1)) {
+            offer_message offer;
+            offer.offered_service_ = service_of_interest_;
+            send_multicast(offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
         }
         if (!_error) {
-            for (std::unordered_map<boost::asio::ip::udp::endpoint, std::unique_ptr<distributed_response_message>>::iterator itr = non_acked_responses_.begin(); itr != non_acked_responses_.end(); itr++) {
-                std::unique_ptr<distributed_response_message> distributed_response = std::make_unique<distributed_response_message>(itr->second.operator*());
-                send_to(distributed_response.operator*(), itr->first); statistics_recorder_->record_count(count_metric::DISTRIBUTED_RESPONSE_MESSAGE_COUNT_);
+            for (std::unordered_map<boost::asio::ip::udp::endpoint, shared_datagram_t>::iterator itr = non_acked_responses_.begin(); itr != non_acked_responses_.end(); itr++) {
+                multicast_application_impl::send_to(itr->second, itr->first); statistics_recorder_->record_count(count_metric::DISTRIBUTED_RESPONSE_MESSAGE_COUNT_);
             }
         }
         if (!_error && (endpoints_acks_rcvd_from_.size() != member_count_-1)) {
@@ -166,19 +244,30 @@ void distributed_dh::send_cyclic_messages() {
     });
 }
 
-void distributed_dh::send_multicast(message& _message) {
-    boost::asio::streambuf buffer;
-    message_handler_->serialize(_message, buffer);
+template <typename group_t>
+void distributed_dh<group_t>::send_multicast(const message& _message) {
+    std::shared_ptr<std::vector<unsigned char>> buffer = acquire_send_buffer();
+    message_handler_->serialize(_message, *buffer);
     multicast_application_impl::send_multicast(buffer);
 }
 
-void distributed_dh::send_to(message& _message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    boost::asio::streambuf buffer;
-    message_handler_->serialize(_message, buffer);
+template <typename group_t>
+void distributed_dh<group_t>::send_to(const message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    std::shared_ptr<std::vector<unsigned char>> buffer = acquire_send_buffer();
+    message_handler_->serialize(_message, *buffer);
     multicast_application_impl::send_to(buffer, _remote_endpoint);
 }
 
-std::string distributed_dh::short_secret_repr(secret_t _secret) {
+template <typename group_t>
+shared_datagram_t distributed_dh<group_t>::serialize(const message& _message) {
+    // Runs on the worker threads, so the buffer does not come from the strand's pool. The response is cached until acknowledged anyway.
+    std::shared_ptr<std::vector<unsigned char>> buffer = std::make_shared<std::vector<unsigned char>>();
+    message_handler_->serialize(_message, *buffer);
+    return buffer;
+}
+
+template <typename group_t>
+std::string distributed_dh<group_t>::short_secret_repr(const secret_t& _secret) {
     CryptoPP::Integer secret_int;
     secret_int.Decode(_secret.BytePtr(), _secret.SizeInBytes());
     std::ostringstream oss;
@@ -189,35 +278,13 @@ std::string distributed_dh::short_secret_repr(secret_t _secret) {
     return oss.str();
 }
 
-bool distributed_dh::group_secret_rcvd() {
+template <typename group_t>
+bool distributed_dh<group_t>::group_secret_rcvd() {
     return group_secret_.SizeInBytes() != 0;
 }
 
-void distributed_dh::process_response(response_message _rcvd_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    // Unused, just here to comply with key_agreement_protocol
-}
-
-void distributed_dh::process_member_info_request(member_info_request_message _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    // Unused, just here to comply with key_agreement_protocol
-}
-
-void distributed_dh::process_member_info_response(member_info_response_message _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    // Unused, just here to comply with key_agreement_protocol
-}
-
-void distributed_dh::process_synch_token(synch_token_message _rcvd_synch_token_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    // Unused, just here to comply with key_agreement_protocol
-}
-
-void distributed_dh::process_member_info_synch_request(member_info_synch_request_message _rcvd_member_info_synch_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    // Unused, just here to comply with key_agreement_protocol
-}
-
-void distributed_dh::process_member_info_synch_response(member_info_synch_response_message _rcvd_member_info_synch_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    // Unused, just here to comply with key_agreement_protocol
-}
-
-void distributed_dh::process_finish(finish_message _rcvd_finish_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void distributed_dh<group_t>::process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (_remote_endpoint != get_local_endpoint()) {
         contribute_statistics();
     }
@@ -225,16 +292,17 @@ void distributed_dh::process_finish(finish_message _rcvd_finish_message, boost::
         scatter_timer_.expires_from_now(scatter_delay_);
         scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
             if (!_error) {
-                std::unique_ptr<finish_message> finish = std::make_unique<finish_message>();
-                send_multicast(finish.operator*()); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
-                std::unique_ptr<finish_message> self_msg = std::make_unique<finish_message>();
-                process_finish(self_msg.operator*(), get_local_endpoint());
+                finish_message finish;
+                send_multicast(finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+                finish_message self_msg;
+                process_finish(self_msg, get_local_endpoint());
             }
         });
     }
 }
 
-void distributed_dh::process_finish_ack(finish_ack_message _rcvd_finish_ack_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void distributed_dh<group_t>::process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     endpoints_acks_rcvd_from_.insert(_remote_endpoint);
     non_acked_responses_.erase(_remote_endpoint);
     if (is_sponsor_ && endpoints_acks_rcvd_from_.size() == member_count_-1) {
@@ -248,10 +316,10 @@ void distributed_dh::process_finish_ack(finish_ack_message _rcvd_finish_ack_mess
                 contribute_statistics();
             }
         });
-        std::unique_ptr<finish_message> finish = std::make_unique<finish_message>();
-        send_multicast(finish.operator*()); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
-        std::unique_ptr<finish_message> self_msg = std::make_unique<finish_message>();
-        process_finish(self_msg.operator*(), get_local_endpoint());
+        finish_message finish;
+        send_multicast(finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+        finish_message self_msg;
+        process_finish(self_msg, get_local_endpoint());
 #else
     statistics_recorder_->record_timestamp(time_metric::DURATION_END_);
     contribute_statistics();
@@ -259,14 +327,25 @@ void distributed_dh::process_finish_ack(finish_ack_message _rcvd_finish_ack_mess
     }
 }
 
-void distributed_dh::contribute_statistics() {
+template <typename group_t>
+void distributed_dh<group_t>::contribute_statistics() {
     if (group_secret_rcvd()) {
+        record_transport_statistics();
         statistics_recorder_->contribute_statistics();
         multicast_application_impl::stop();
     }
 }
 
-std::chrono::milliseconds distributed_dh::compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max) {
+template <typename group_t>
+void distributed_dh<group_t>::record_transport_statistics() {
+    transport_statistics statistics = multicast_application_impl::get_transport_statistics();
+    statistics_recorder_->record_count(count_metric::KERNEL_DROP_COUNT_, statistics.kernel_drops_);
+    statistics_recorder_->record_maximum(count_metric::RECEIVE_QUEUE_HIGH_WATER_MARK_, statistics.receive_queue_high_water_mark_);
+    statistics_recorder_->record_maximum(count_metric::SEND_QUEUE_HIGH_WATER_MARK_, statistics.send_queue_high_water_mark_);
+}
+
+template <typename group_t>
+std::chrono::milliseconds distributed_dh<group_t>::compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max) {
     if (_scatter_delay_min > _scatter_delay_max) {
         const std::uint32_t tmp(_scatter_delay_min);
         _scatter_delay_min = _scatter_delay_max;
@@ -277,4 +356,8 @@ std::chrono::milliseconds distributed_dh::compute_scatter_delay(std::uint32_t _s
     std::uniform_int_distribution<std::uint32_t> distribution(
             _scatter_delay_min, _scatter_delay_max);
     return std::chrono::milliseconds(distribution(mersenne_twister));
-}
\ No newline at end of file
+}
+
+template class distributed_dh<default_dh_group>;
+template class distributed_dh<ecc_dh_group>;
+template class distributed_dh<x25519_dh_group>;
@@ -3,67 +3,72 @@
 
 #include "key_agreement_protocol.hpp"
 #include "primitives.hpp"
+#include "point_codec.hpp"
+#include "crypto_groups.hpp"
+#include "key_pair_pool.hpp"
 #include "message_handler.hpp"
 #include "multicast_application_impl.hpp"
 #include "statistics_recorder.hpp"
 
-#include <cryptopp/dh.h>
-#include <cryptopp/eccrypto.h>
 #include <cryptopp/osrng.h>
 #include <unordered_map>
 #include <unordered_set>
 
+// Instantiated with the crypto group policies of crypto_groups.hpp in distributed_dh.cpp
+template <typename group_t>
 class distributed_dh : public key_agreement_protocol, public multicast_application_impl {
     // Variables
     public:
+        // Dispatched by message_handler, all other message types are dropped before decoding
+        typedef handled_messages<find_message, offer_message, request_message, distributed_response_message,
+                                 finish_message, finish_ack_message> handled_messages_t;
     protected:
     private:
-#ifdef DEFAULT_DH
-        CryptoPP::DH diffie_hellman_;
-#elif defined(ECC_DH)
-        CryptoPP::ECDH<CryptoPP::ECP>::Domain diffie_hellman_;
-#endif
-        std::mutex receive_mutex_;
+        typename group_t::domain_t diffie_hellman_;
         service_id_t service_of_interest_ = DEFAULT_SERVICE_ID;
         bool is_sponsor_;
         CryptoPP::AutoSeededRandomPool rnd_;
         secret_t group_secret_;
         secret_t secret_;
         blinded_secret_t blinded_secret_;
-        std::unique_ptr<message_handler> message_handler_;
+        point_codec<typename group_t::domain_t> point_codec_;
+        // blinded_secret_ as sent on the wire
+        byte_view_t wire_blinded_secret_;
+        std::unique_ptr<message_handler<distributed_dh>> message_handler_;
         std::uint32_t member_count_;
         std::unique_ptr<statistics_recorder> statistics_recorder_;
         std::chrono::milliseconds scatter_delay_;
         boost::asio::steady_timer scatter_timer_;
         boost::asio::steady_timer timeout_timer_;
-        std::unordered_map<boost::asio::ip::udp::endpoint, std::unique_ptr<distributed_response_message>> non_acked_responses_;
+        // Serialized once, retransmissions resend the same bytes
+        std::unordered_map<boost::asio::ip::udp::endpoint, shared_datagram_t> non_acked_responses_;
         std::unordered_set<boost::asio::ip::udp::endpoint> endpoints_acks_rcvd_from_;
+        std::unordered_set<boost::asio::ip::udp::endpoint> responses_in_progress_;
     // Methods
     public:
-        distributed_dh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port);
+        distributed_dh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count = 1, std::uint32_t _send_rate = 0, in_memory_bus* _in_memory_bus = nullptr);
         ~distributed_dh();
         void start();
         virtual void received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_find(find_message _rcvd_find_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_offer(offer_message _rcvd_offer_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_request(request_message _rcvd_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_response(response_message _rcvd_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_request(member_info_request_message _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_response(member_info_response_message _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_synch_token(synch_token_message _rcvd_synch_token_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_synch_request(member_info_synch_request_message _rcvd_member_info_synch_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_synch_response(member_info_synch_response_message _rcvd_member_info_synch_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_distributed_response(distributed_response_message _rcvd_distributed_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_finish(finish_message _rcvd_finish_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_finish_ack(finish_ack_message _rcvd_finish_ack_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+        void process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_distributed_response(const distributed_response_message& _rcvd_distributed_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        bool is_relevant(const message_header& _header);
     protected:
     private:
         bool group_secret_rcvd();
+        shared_datagram_t compute_distributed_response(const blinded_secret_t& _blinded_member_secret, const std::vector<CryptoPP::byte>& _iv_vector);
+        void send_distributed_response(shared_datagram_t _serialized_response, const boost::asio::ip::udp::endpoint& _remote_endpoint);
         void send_cyclic_messages();
-        void send_multicast(message& _message);
-        void send_to(message& _message, boost::asio::ip::udp::endpoint _remote_endpoint);
-        std::string short_secret_repr(secret_t _secret);
+        void send_multicast(const message& _message);
+        void send_to(const message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        shared_datagram_t serialize(const message& _message);
+        std::string short_secret_repr(const secret_t& _secret);
         void contribute_statistics();
+        void record_transport_statistics();
         std::chrono::milliseconds compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max);
 };
 
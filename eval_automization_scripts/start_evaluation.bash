@@ -1,10 +1,8 @@
 #!/bin/bash
 
+# All protocols and crypto algorithms are built into one binary and selected per run, so this only rebuilds after source changes
 compile() {
-    local CRYPTO_ALGORITHM=$1
-    local KEY_AGREEMENT_PROTOCOL=$2
-    local ABSOLUTE_PROJECT_PATH=$3
-    sed -i -E "s/add_compile_definitions\(.*\)/add_compile_definitions($CRYPTO_ALGORITHM $KEY_AGREEMENT_PROTOCOL)/" ${ABSOLUTE_PROJECT_PATH}/CMakeLists.txt
+    local ABSOLUTE_PROJECT_PATH=$1
     echo "Compiling all targets..."
     $(which cmake) --build ${ABSOLUTE_PROJECT_PATH}/build --config Release --target all -j $(nproc) --
     echo "All targets are compiled."
@@ -37,7 +35,7 @@ start() {
 
     echo "Starting $KEY_AGREEMENT_PROTOCOL $CRYPTO_ALGORITHM with $MEMBER_COUNT members"
 
-    ${ABSOLUTE_PROJECT_PATH}/build/statistics-writer-main $MEMBER_COUNT $ABSOLUTE_RESULTS_DIRECTORY_PATH &
+    ${ABSOLUTE_PROJECT_PATH}/build/statistics-writer-main $MEMBER_COUNT $ABSOLUTE_RESULTS_DIRECTORY_PATH --protocol=$KEY_AGREEMENT_PROTOCOL --crypto=$CRYPTO_ALGORITHM &
     while [[ -z $(pgrep statistics-wr) ]]; do
         echo "Waiting for statistics writer to start up"
         sleep 1
@@ -46,7 +44,7 @@ start() {
 
     for (( i=0; i<$(get_subscriber_count $MEMBER_COUNT); i++ ))
     do
-        ${ABSOLUTE_PROJECT_PATH}/build/multicast-dh-example false $SERVICE_ID $MEMBER_COUNT $SCATTER_DELAY_MIN $SCATTER_DELAY_MAX $LISTENING_INTERFACE_BY_IP $MULTICAST_IP $MULTICAST_PORT &
+        ${ABSOLUTE_PROJECT_PATH}/build/multicast-dh-example false $SERVICE_ID $MEMBER_COUNT $SCATTER_DELAY_MIN $SCATTER_DELAY_MAX $LISTENING_INTERFACE_BY_IP $MULTICAST_IP $MULTICAST_PORT --protocol=$KEY_AGREEMENT_PROTOCOL --crypto=$CRYPTO_ALGORITHM &
     done
     while [[ $(get_process_count) -ne $(get_subscriber_count $MEMBER_COUNT) ]]; do
         echo "Waiting for all subscribers to start up, $(get_process_count)/$(get_subscriber_count $MEMBER_COUNT) are up"
@@ -54,10 +52,10 @@ start() {
     done
     echo "All subscribers started up"
     while [[ $(get_members_up_count_by_unique_ports $MULTICAST_PORT) < $(get_subscriber_count $MEMBER_COUNT) ]]; do
-        echo "There are still ports bound more than once"
+        echo "Waiting for all subscribers to bind their unicast ports"
         sleep 1
     done
-    ${ABSOLUTE_PROJECT_PATH}/build/multicast-dh-example true $SERVICE_ID $MEMBER_COUNT $SCATTER_DELAY_MIN $SCATTER_DELAY_MAX $LISTENING_INTERFACE_BY_IP $MULTICAST_IP $MULTICAST_PORT &
+    ${ABSOLUTE_PROJECT_PATH}/build/multicast-dh-example true $SERVICE_ID $MEMBER_COUNT $SCATTER_DELAY_MIN $SCATTER_DELAY_MAX $LISTENING_INTERFACE_BY_IP $MULTICAST_IP $MULTICAST_PORT --protocol=$KEY_AGREEMENT_PROTOCOL --crypto=$CRYPTO_ALGORITHM &
     # while [[ $(get_process_count) -ne $MEMBER_COUNT ]]; do
     #     echo "Waiting for initial sponsor to start up"
     #     sleep 1
@@ -92,7 +90,7 @@ function on_exit() {
 if [ $# -ne 11 ]; then
     echo "Not enough parameters" 1>&2
     echo "Usage: $0 <service_id> <member_count> <scatter_delay_min(ms)> <scatter_delay_max(ms)> <crypto_algorithm> <key_agreement_protocol> <absolute_project_path> <absolute_results_directory_path> <listening_interface_by_ip> <multicast_ip> <multicast_port>"
-    echo "Example: $0 42 20 10 100 DEFAULT_DH|ECC_DH PROTO_STR_DH|PROTO_DST_DH /path/to/project/directory /path/to/results/directory 127.0.0.1 239.255.0.1 65000"
+    echo "Example: $0 42 20 10 100 DEFAULT_DH|ECC_DH|X25519_DH PROTO_STR_DH|PROTO_DST_DH|PROTO_TGDH /path/to/project/directory /path/to/results/directory 127.0.0.1 239.255.0.1 65000"
     exit 1
 fi
 
@@ -106,13 +104,13 @@ if [[ $2 -lt 2 ]]; then
     exit 1
 fi
 
-if [[ $5 != "DEFAULT_DH" && $5 != "ECC_DH" ]]; then
-    echo "Crypto algorithm must be DEFAULT_DH|ECC_DH"
+if [[ $5 != "DEFAULT_DH" && $5 != "ECC_DH" && $5 != "X25519_DH" ]]; then
+    echo "Crypto algorithm must be DEFAULT_DH|ECC_DH|X25519_DH"
     exit 1
 fi
 
-if [[ $6 != "PROTO_STR_DH" && $6 != "PROTO_DST_DH" ]]; then
-    echo "Key agreement must be PROTO_STR_DH|PROTO_DST_DH"
+if [[ $6 != "PROTO_STR_DH" && $6 != "PROTO_DST_DH" && $6 != "PROTO_TGDH" ]]; then
+    echo "Key agreement must be PROTO_STR_DH|PROTO_DST_DH|PROTO_TGDH"
     exit 1
 fi
 
@@ -124,5 +122,5 @@ if [[ $last_char == "/" ]]; then
 fi
 trap 'on_exit' SIGINT
 
-compile $5 $6 $CORRECTED_ABSOLUTE_PROJECT_PATH
+compile $CORRECTED_ABSOLUTE_PROJECT_PATH
 start $1 $2 $3 $4 $5 $6 $CORRECTED_ABSOLUTE_PROJECT_PATH $8 $9 ${10} ${11}
\ No newline at end of file
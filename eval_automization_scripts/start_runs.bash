@@ -7,8 +7,8 @@ SCATTER_DELAY_MAX=0
 LISTENING_INTERFACE_BY_IP="127.0.0.1"
 MULTICAST_IP="239.255.0.1"
 MULTICAST_PORT=65000
-KEY_AGREEMENT_PROTOCOL=('PROTO_DST_DH' 'PROTO_STR_DH')
-CRYPTO_ALGORITHM=('DEFAULT_DH' 'ECC_DH')
+KEY_AGREEMENT_PROTOCOL=('PROTO_DST_DH' 'PROTO_STR_DH' 'PROTO_TGDH')
+CRYPTO_ALGORITHM=('DEFAULT_DH' 'ECC_DH' 'X25519_DH')
 
 RUNS=100
 
@@ -0,0 +1,58 @@
+#ifndef CRYPTO_GROUPS
+#define CRYPTO_GROUPS
+
+#include <cryptopp/dh.h>
+#include <cryptopp/eccrypto.h>
+#include <cryptopp/oids.h>
+#include <cryptopp/xed25519.h>
+#include <string>
+#include "MODP2048_256sg.hpp"
+#include "group_precomputation.hpp"
+
+// Crypto group policies the key agreement protocols are instantiated with. Every policy names the Crypto++ domain
+// and initializes it, so the protocols stay specialized at compile time while all groups are compiled into one binary.
+
+struct default_dh_group {
+    typedef CryptoPP::DH domain_t;
+    static constexpr const char* name_ = "DEFAULT_DH";
+
+    static void initialize(domain_t& _diffie_hellman) {
+        _diffie_hellman.AccessGroupParameters().Initialize(P, Q, G);
+        group_precomputation::apply(_diffie_hellman.AccessGroupParameters(), "modp2048_256");
+    }
+};
+
+struct ecc_dh_group {
+    typedef CryptoPP::ECDH<CryptoPP::ECP>::Domain domain_t;
+    static constexpr const char* name_ = "ECC_DH";
+
+    static void initialize(domain_t& _diffie_hellman) {
+        _diffie_hellman.AccessGroupParameters().Initialize(CryptoPP::ASN1::secp256r1());
+        group_precomputation::apply(_diffie_hellman.AccessGroupParameters(), "secp256r1");
+    }
+};
+
+struct x25519_dh_group {
+    typedef CryptoPP::x25519 domain_t;
+    static constexpr const char* name_ = "X25519_DH";
+
+    // Curve25519 has fixed parameters and no fixed-base tables in Crypto++
+    static void initialize(domain_t& _diffie_hellman) {}
+};
+
+// Calls _function with the policy of the group named _crypto_algorithm, returns false for unknown names
+template <typename F>
+bool with_crypto_group(const std::string& _crypto_algorithm, F&& _function) {
+    if (_crypto_algorithm == default_dh_group::name_) {
+        _function(default_dh_group());
+    } else if (_crypto_algorithm == ecc_dh_group::name_) {
+        _function(ecc_dh_group());
+    } else if (_crypto_algorithm == x25519_dh_group::name_) {
+        _function(x25519_dh_group());
+    } else {
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef GROUP_PRECOMPUTATION
+#define GROUP_PRECOMPUTATION
+
+#include <cryptopp/cryptlib.h>
+#include <cryptopp/integer.h>
+#include <cryptopp/queue.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Fixed-base precomputation for GeneratePublicKey: Crypto++ stores powers of the generator (windowed comb tables),
+// so exponentiations of the generator need a fraction of the squarings. The tables of a group are built by the first
+// process and written to a read-only file in the user's cache directory, all other processes and every further member of
+// the same process (in-memory simulation) only load them. Key agreements with other bases (Agree) are not affected.
+class group_precomputation {
+// Variables
+public:
+    // Number of precomputed powers of the generator
+    enum { storage = 16 };
+private:
+    static inline std::mutex mutex_;
+    // Serialized tables per group, as saved by Crypto++, only verified tables are kept
+    static inline std::unordered_map<std::string, std::string> tables_;
+// Methods
+public:
+    template <typename T>
+    static void apply(T& _group_parameters, const std::string& _group_name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string& table = tables_[_group_name];
+        if (!table.empty()) {
+            load(_group_parameters, table);
+            return;
+        }
+        std::string cached_table = read_file(_group_name);
+        if (!cached_table.empty()) {
+            if (load_verified(_group_parameters, cached_table, _group_name)) {
+                table = cached_table;
+                return;
+            }
+        }
+        _group_parameters.Precompute(storage);
+        CryptoPP::ByteQueue queue;
+        _group_parameters.SavePrecomputation(queue);
+        table.resize(queue.MaxRetrievable());
+        queue.Get(reinterpret_cast<CryptoPP::byte*>(table.data()), table.size());
+        write_file(_group_name, table);
+    }
+private:
+    template <typename T>
+    static void load(T& _group_parameters, const std::string& _table) {
+        CryptoPP::ByteQueue queue;
+        queue.Put(reinterpret_cast<const CryptoPP::byte*>(_table.data()), _table.size());
+        _group_parameters.LoadPrecomputation(queue);
+    }
+
+    // Loading the tables replaces the base as well, so a stale or foreign file must not change the generator behind every
+    // public key: the base has to be the generator and one exponentiation has to match the result without tables.
+    // Otherwise the generator is restored and false returned.
+    template <typename T>
+    static bool load_verified(T& _group_parameters, const std::string& _table, const std::string& _group_name) {
+        const typename T::Element generator = _group_parameters.GetSubgroupGenerator();
+        const CryptoPP::Integer exponent = _group_parameters.GetSubgroupOrder() - 1;
+        const typename T::Element expected_power = _group_parameters.ExponentiateBase(exponent);
+        try {
+            load(_group_parameters, _table);
+            if (_group_parameters.GetSubgroupGenerator() == generator && _group_parameters.ExponentiateBase(exponent) == expected_power) {
+                return true;
+            }
+            std::cerr << "[<group_precomputation>]: Rebuilding the tables of " << _group_name << ", the cached tables do not match the generator" << std::endl;
+        } catch (const CryptoPP::Exception& _exception) {
+            std::cerr << "[<group_precomputation>]: Rebuilding the tables of " << _group_name << ", " << _exception.what() << std::endl;
+        }
+        _group_parameters.SetSubgroupGenerator(generator);
+        return false;
+    }
+
+    // $XDG_CACHE_HOME/dh-gka or ~/.cache/dh-gka, empty if neither is set (the tables are then only kept in memory)
+    static std::filesystem::path cache_directory() {
+        if (const char* cache_home = std::getenv("XDG_CACHE_HOME"); cache_home && *cache_home) {
+            return std::filesystem::path(cache_home) / "dh-gka";
+        }
+        if (const char* home = std::getenv("HOME"); home && *home) {
+            return std::filesystem::path(home) / ".cache" / "dh-gka";
+        }
+        return std::filesystem::path();
+    }
+
+    static std::filesystem::path file_path(const std::string& _group_name) {
+        std::filesystem::path directory = cache_directory();
+        return directory.empty() ? directory : directory / (_group_name + ".precomputation");
+    }
+
+    static std::string read_file(const std::string& _group_name) {
+        std::filesystem::path path = file_path(_group_name);
+        if (path.empty()) {
+            return std::string();
+        }
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    static void write_file(const std::string& _group_name, const std::string& _table) {
+        // Written under a process-specific name and renamed, so concurrent processes never read a partial file
+        std::filesystem::path path = file_path(_group_name);
+        if (path.empty()) {
+            return;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        std::filesystem::permissions(path.parent_path(), std::filesystem::perms::owner_all, error);
+        std::filesystem::path temporary_path = path;
+        temporary_path += "." + std::to_string(getpid());
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            file.write(_table.data(), _table.size());
+            if (!file) {
+                std::cerr << "[<group_precomputation>]: Could not write " << temporary_path << std::endl;
+                return;
+            }
+        }
+        std::filesystem::permissions(temporary_path, std::filesystem::perms::owner_read, error);
+        std::filesystem::rename(temporary_path, path, error);
+        if (error) {
+            std::cerr << "[<group_precomputation>]: Could not write " << path << ", " << error.message() << std::endl;
+            std::filesystem::remove(temporary_path, error);
+        }
+    }
+};
+
+#endif
@@ -3,23 +3,18 @@
 
 #include "../message_handler/message.hpp"
 
+// A protocol declares the messages it handles as handled_messages_t and provides the matching process_* methods,
+// message_handler<T> dispatches to them without virtual calls and drops all other message types before decoding.
+// Optionally, bool is_relevant(const message_header&) drops handled messages by their header before decoding.
+template <typename... T>
+struct handled_messages {
+};
+
 class key_agreement_protocol {
 private:
 
 public:
     virtual ~key_agreement_protocol() {}
-    virtual void process_find(find_message _rcvd_find_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_offer(offer_message _rcvd_offer_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_request(request_message _rcvd_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_response(response_message _rcvd_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_member_info_request(member_info_request_message _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_member_info_response(member_info_response_message _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_synch_token(synch_token_message _rcvd_synch_token_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_member_info_synch_request(member_info_synch_request_message _rcvd_member_info_synch_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_member_info_synch_response(member_info_synch_response_message _rcvd_member_info_synch_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_distributed_response(distributed_response_message _rcvd_distributed_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_finish(finish_message _rcvd_finish_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
-    virtual void process_finish_ack(finish_ack_message _rcvd_finish_ack_message, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
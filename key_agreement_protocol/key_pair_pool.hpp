@@ -0,0 +1,107 @@
+#ifndef KEY_PAIR_POOL
+#define KEY_PAIR_POOL
+
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cryptopp/osrng.h>
+#include <cryptopp/secblock.h>
+#include "primitives.hpp"
+
+// Generates (secret, blinded secret) key pairs ahead of time on background threads, so members pull a ready-made pair
+// instead of running GeneratePrivateKey and GeneratePublicKey on their startup path. One pool per process and group,
+// which pays off when a process hosts many members (in-memory simulation): their key pairs are generated in parallel
+// while the members are constructed one after another. At most capacity pairs are generated in total, so the threads
+// are done once the members are built and do not compete with the key agreement for the CPU.
+template <typename T>
+class key_pair_pool {
+// Variables
+private:
+    struct key_pair {
+        secret_t secret_;
+        blinded_secret_t blinded_secret_;
+    };
+    static inline std::mutex instance_mutex_;
+    static inline std::unique_ptr<key_pair_pool> instance_;
+    // Pairs still to be generated, including those in progress
+    size_t remaining_count_;
+    const size_t capacity_;
+    const std::uint32_t generator_thread_count_;
+    std::deque<std::unique_ptr<key_pair>> key_pairs_;
+    std::mutex mutex_;
+    bool stopped_;
+    std::vector<std::thread> generator_threads_;
+// Methods
+public:
+    // The first call creates the pool from the initialized _diffie_hellman domain, later calls return it. Returns nullptr
+    // if a later call asks for another capacity or thread count, the caller then generates its own pairs.
+    static key_pair_pool* get_instance(const T& _diffie_hellman, size_t _capacity, std::uint32_t _generator_thread_count) {
+        std::lock_guard<std::mutex> lock(instance_mutex_);
+        if (!instance_) {
+            instance_ = std::make_unique<key_pair_pool>(_diffie_hellman, _capacity, _generator_thread_count);
+        } else if (instance_->capacity_ != _capacity || instance_->generator_thread_count_ != _generator_thread_count) {
+            std::cerr << "[<key_pair_pool>]: Pool of " << instance_->capacity_ << " pairs and " << instance_->generator_thread_count_
+                      << " threads requested with " << _capacity << " pairs and " << _generator_thread_count << " threads" << std::endl;
+            return nullptr;
+        }
+        return instance_.get();
+    }
+
+    key_pair_pool(const T& _diffie_hellman, size_t _capacity, std::uint32_t _generator_thread_count) : remaining_count_(_capacity), capacity_(_capacity), generator_thread_count_(_generator_thread_count), stopped_(false) {
+        for (std::uint32_t i = 0; i < _generator_thread_count; i++) {
+            // Each thread works on its own copy of the domain, Crypto++ objects must not be shared between threads
+            generator_threads_.emplace_back(&key_pair_pool::generate, this, _diffie_hellman);
+        }
+    }
+
+    ~key_pair_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        for (std::thread& generator_thread : generator_threads_) {
+            generator_thread.join();
+        }
+    }
+
+    // Returns false if no pair is ready yet, the caller then generates its own instead of waiting
+    bool pull(secret_t& _secret, blinded_secret_t& _blinded_secret) {
+        std::unique_ptr<key_pair> pair;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (key_pairs_.empty()) {
+                // The caller's pair is not generated here anymore
+                if (remaining_count_ > 0) {
+                    remaining_count_--;
+                }
+                return false;
+            }
+            pair = std::move(key_pairs_.front());
+            key_pairs_.pop_front();
+        }
+        _secret.swap(pair->secret_);
+        _blinded_secret.swap(pair->blinded_secret_);
+        return true;
+    }
+private:
+    void generate(T _diffie_hellman) {
+        CryptoPP::AutoSeededRandomPool rng;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopped_ && remaining_count_ > 0) {
+            remaining_count_--;
+            lock.unlock();
+            std::unique_ptr<key_pair> pair = std::make_unique<key_pair>();
+            pair->secret_.New(_diffie_hellman.PrivateKeyLength());
+            pair->blinded_secret_.New(_diffie_hellman.PublicKeyLength());
+            _diffie_hellman.GeneratePrivateKey(rng, pair->secret_);
+            _diffie_hellman.GeneratePublicKey(rng, pair->secret_, pair->blinded_secret_);
+            lock.lock();
+            key_pairs_.push_back(std::move(pair));
+        }
+    }
+};
+
+#endif
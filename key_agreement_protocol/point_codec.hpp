@@ -0,0 +1,95 @@
+#ifndef POINT_CODEC
+#define POINT_CODEC
+
+#include <cryptopp/secblock.h>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#ifdef COMPRESSED_POINTS
+#include <cryptopp/eccrypto.h>
+#include <cryptopp/ecp.h>
+#endif
+#include "primitives.hpp"
+
+// Converts blinded secrets between the form used by the key agreement with domain T and the form sent on the wire.
+// Blinded secrets are sent as they are, except for ECDH domains with COMPRESSED_POINTS (specialization below).
+template <typename T>
+class point_codec {
+// Methods
+public:
+    void initialize(const T& _diffie_hellman) {
+    }
+
+    byte_view_t to_wire(const blinded_secret_t& _blinded_secret) {
+        return byte_view_t(_blinded_secret.BytePtr(), _blinded_secret.SizeInBytes());
+    }
+
+    blinded_secret_t from_wire(byte_view_t _wire_point) {
+        return blinded_secret_t(_wire_point.data(), _wire_point.size());
+    }
+};
+
+#ifdef COMPRESSED_POINTS
+// Points are sent compressed (33 instead of 65 bytes on secp256r1). Compressed points are kept per point sent, so views
+// returned by to_wire stay valid as long as the codec, only the own and sponsored points are sent. Decompressions are
+// cached in a small direct-mapped table, so retransmitted points are not decompressed again while memory stays bounded
+// however many members or forged points arrive. Failed decompressions are not cached. Not thread-safe.
+template <>
+class point_codec<CryptoPP::ECDH<CryptoPP::ECP>::Domain> {
+// Variables
+private:
+    enum { decompression_cache_size = 64 };
+    struct point_hash {
+        size_t operator()(byte_view_t _point) const {
+            return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(_point.data()), _point.size()));
+        }
+        size_t operator()(const blinded_secret_t& _point) const {
+            return operator()(byte_view_t(_point.BytePtr(), _point.SizeInBytes()));
+        }
+    };
+    struct decompressed_point {
+        blinded_secret_t wire_point_;
+        blinded_secret_t point_;
+    };
+    std::unique_ptr<CryptoPP::ECP> curve_;
+    std::unordered_map<blinded_secret_t, blinded_secret_t, point_hash> compressed_points_;
+    std::array<decompressed_point, decompression_cache_size> decompressed_points_;
+// Methods
+public:
+    void initialize(const CryptoPP::ECDH<CryptoPP::ECP>::Domain& _diffie_hellman) {
+        curve_ = std::make_unique<CryptoPP::ECP>(_diffie_hellman.GetGroupParameters().GetCurve());
+    }
+
+    byte_view_t to_wire(const blinded_secret_t& _blinded_secret) {
+        auto compressed_point = compressed_points_.try_emplace(_blinded_secret);
+        if (compressed_point.second) {
+            CryptoPP::ECP::Point point;
+            if (curve_->DecodePoint(point, _blinded_secret.BytePtr(), _blinded_secret.SizeInBytes())) {
+                compressed_point.first->second.New(curve_->EncodedPointSize(true));
+                curve_->EncodePoint(compressed_point.first->second.BytePtr(), point, true);
+            }
+        }
+        return byte_view_t(compressed_point.first->second.BytePtr(), compressed_point.first->second.SizeInBytes());
+    }
+
+    // Returns an empty blinded secret if the bytes are no point on the curve
+    blinded_secret_t from_wire(byte_view_t _wire_point) {
+        decompressed_point& cached_point = decompressed_points_[point_hash()(_wire_point) % decompression_cache_size];
+        if (cached_point.wire_point_.SizeInBytes() == _wire_point.size() && std::equal(_wire_point.begin(), _wire_point.end(), cached_point.wire_point_.BytePtr())) {
+            return cached_point.point_;
+        }
+        CryptoPP::ECP::Point point;
+        if (!curve_->DecodePoint(point, _wire_point.data(), _wire_point.size()) || !curve_->VerifyPoint(point)) {
+            return blinded_secret_t();
+        }
+        cached_point.wire_point_.Assign(_wire_point.data(), _wire_point.size());
+        cached_point.point_.New(curve_->EncodedPointSize(false));
+        curve_->EncodePoint(cached_point.point_.BytePtr(), point, false);
+        return cached_point.point_;
+    }
+};
+#endif
+
+#endif
@@ -2,22 +2,14 @@
 #define MESSAGE
 
 #include <vector>
-#include <sstream>
 #include <boost/asio.hpp>
-#include <cryptopp/integer.h>
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/archive/binary_oarchive.hpp>
-#include <boost/serialization/vector.hpp>
-#include <boost/serialization/version.hpp>
-#include <boost/serialization/base_object.hpp>
+#include <cryptopp/secblock.h>
 #include <boost/asio/ip/address.hpp>
-#include <boost/asio/streambuf.hpp>
-#include <boost/algorithm/string.hpp>
 #include "primitives.hpp"
+#include "wire_format.hpp"
 #include "logger.hpp"
 
-#define LAST_IP_FIELD_IDX 3
-#define MESSAGE_ID_SIZE 1 
+#define MESSAGE_ID_SIZE 1
 
 enum message_type {
     NONE,
@@ -32,400 +24,345 @@ enum message_type {
     MEMBER_INFO_SYNCH_RESPONSE,
     DISTRIBUTED_RESPONSE,
     FINISH,
-    FINISH_ACK
+    FINISH_ACK,
+    BLINDED_KEY
 };
 
-static std::vector<unsigned char> get_secbyteblock_as_byte_vector(CryptoPP::SecByteBlock _secbyteblock) {
-    std::vector<unsigned char> byte_vector(_secbyteblock.BytePtr(), _secbyteblock.BytePtr()+_secbyteblock.SizeInBytes());
-    return byte_vector;
-}
-
-static CryptoPP::SecByteBlock get_byte_vector_as_secbyteblock(std::vector<unsigned char> _byte_vector) {
-    CryptoPP::SecByteBlock secbyteblock;
-    secbyteblock.Assign(_byte_vector.data(), _byte_vector.size());
-    return secbyteblock;
-}
-
-static std::vector<unsigned char> get_cryptopp_integer_as_byte_vector(CryptoPP::Integer _integer) {
-    std::vector<unsigned char> byte_vector;
-    for (size_t i = 0; i < _integer.ByteCount(); i++) {
-        byte_vector.push_back(_integer.GetByte(i));
-    }
-    return byte_vector;
-}
-
-static CryptoPP::Integer get_byte_vector_as_cryptopp_integer(std::vector<unsigned char> _byte_vector) {
-    CryptoPP::Integer integer;
-    for (size_t i = 0; i < _byte_vector.size(); i++) {
-        integer.SetByte(i, _byte_vector[i]);
-    }
-    return integer;
-}
-
-static std::vector<unsigned char> get_ipv4_address_as_byte_vector(boost::asio::ip::address_v4 _ip_address) {
-    std::vector<std::string> ip_fields;
-    std::vector<unsigned char> byte_vector;
-    boost::split(ip_fields, _ip_address.to_string(), boost::is_any_of("."));
-    for (auto byte : ip_fields) {
-        byte_vector.push_back(stoi(byte));
-    }
-    return byte_vector;
-}
-
-static void read_from_streambuf(boost::asio::streambuf& _buffer, char* _data, std::streamsize _byte_count){
-    std::istream iss(&_buffer);
-    iss.read(_data, _byte_count);
-}
-
-static void write_to_streambuf(boost::asio::streambuf& _buffer, const char* _data, std::streamsize _byte_count) {
-    std::ostream oss(&_buffer);
-    oss.write(_data, _byte_count);
-}
-
-static boost::asio::ip::address_v4 get_byte_vector_as_ipv4_address(std::vector<unsigned char> _byte_vector) {
-    std::stringstream ss;
-    for (size_t i = 0; i < _byte_vector.size(); i++) {
-        ss << std::to_string(_byte_vector[i]);
-        ss << (i < LAST_IP_FIELD_IDX ? "." : ""); 
-    }
-    return boost::asio::ip::address_v4::from_string(ss.str());
-}
+#define MESSAGE_TYPE_COUNT (message_type::BLINDED_KEY + 1)
 
+// Every message starts with a header of message type, service id and target member id, which message_handler
+// peeks at before decoding, so a protocol drops irrelevant datagrams after a few compares. Messages not bound to a
+// service or not addressed to a single member carry ANY_SERVICE_ID or ANY_MEMBER_ID.
+// Each message type encodes its fixed-size fields at the *_offset constants behind those of its base,
+// followed by its variable-size fields in declaration order. fixed_length_() of the most derived type
+// marks where the variable-size fields start.
+// Variable-size fields are views: a message being sent borrows the sender's buffers, which must outlive
+// its serialization, and a received message points into the datagram and is only valid during the callback.
 struct message {
     public:
+        static constexpr size_t message_type_offset = 0;
+        static constexpr size_t service_id_offset = message_type_offset + MESSAGE_ID_SIZE;
+        static constexpr size_t target_member_id_offset = service_id_offset + sizeof(service_id_t);
+        static constexpr size_t fixed_length = target_member_id_offset + sizeof(member_id_t);
         message_id_t message_type_;
+        static constexpr message_id_t message_id = message_type::NONE;
         message() {
-            message_type_ = message_type::NONE;
+            message_type_ = message_id;
         }
 
-        virtual void serialize_(boost::asio::streambuf& _buffer) {
-            make_members_serializable();
-            std::ostream oss(&_buffer);
-            boost::archive::binary_oarchive oarchive(oss);
-            write_to_archive(oarchive);
+        virtual size_t fixed_length_() const {
+            return fixed_length;
         }
 
-        virtual void deserialize_(boost::asio::streambuf& _buffer) {
-            std::istream iss(&_buffer);
-            boost::archive::binary_iarchive iarchive(iss);
-            read_from_archive(iarchive);
-            deserialize_members();
-        }
-    protected:
-        virtual void make_members_serializable() {
-            // Override in messages who need to make
-            // non-serializable members serializable   
+        virtual size_t encoded_length_() const {
+            return fixed_length_();
         }
 
-        virtual void deserialize_members() {
-            // Override in messages who needed to make
-            // non-serializable members serializable   
+        virtual service_id_t service_id_() const {
+            return ANY_SERVICE_ID;
         }
 
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) {
-            _oarchive << *this;
+        virtual member_id_t target_member_id_() const {
+            return ANY_MEMBER_ID;
         }
 
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) {
-            _iarchive >> *this;
+        virtual void encode_(wire_writer& _writer) const {
+            _writer.write<message_id_t>(message_type_offset, message_type_);
+            _writer.write<service_id_t>(service_id_offset, service_id_());
+            _writer.write<member_id_t>(target_member_id_offset, target_member_id_());
         }
-    private:
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & message_type_;
+
+        virtual void decode_(wire_reader& _reader) {
+            message_type_ = _reader.read<message_id_t>(message_type_offset);
         }
 };
 
+// Header of a received datagram, read without decoding the message
+struct message_header {
+    message_id_t message_type_;
+    service_id_t service_id_;
+    member_id_t target_member_id_;
+};
+
 struct find_message : message {
     public:
+        // Encoded in the header
+        static constexpr size_t required_service_offset = message::service_id_offset;
+        static constexpr size_t fixed_length = message::fixed_length;
+        static constexpr message_id_t message_id = message_type::FIND;
         find_message() {
-            message_type_ = message_type::FIND;
+            message_type_ = message_id;
         }
         service_id_t required_service_;
-    protected:
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
-        }
 
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
+        virtual service_id_t service_id_() const override {
+            return required_service_;
         }
-    private:
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<message>(*this);
-            ar & required_service_;
+
+        virtual void decode_(wire_reader& _reader) override {
+            message::decode_(_reader);
+            required_service_ = _reader.read<service_id_t>(required_service_offset);
         }
 };
 
 struct offer_message : message {
     public:
+        // Encoded in the header
+        static constexpr size_t offered_service_offset = message::service_id_offset;
+        static constexpr size_t fixed_length = message::fixed_length;
+        static constexpr message_id_t message_id = message_type::OFFER;
         offer_message() {
-            message_type_ = message_type::OFFER;
+            message_type_ = message_id;
         }
         service_id_t offered_service_;
-    protected:
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
-        }
 
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
+        virtual service_id_t service_id_() const override {
+            return offered_service_;
         }
-    private:
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<message>(*this);
-            ar & offered_service_;
+
+        virtual void decode_(wire_reader& _reader) override {
+            message::decode_(_reader);
+            offered_service_ = _reader.read<service_id_t>(offered_service_offset);
         }
 };
 
 struct request_message : find_message {
     public:
+        static constexpr message_id_t message_id = message_type::REQUEST;
         request_message() {
-            message_type_ = message_type::REQUEST;
-        }
-        blinded_secret_t blinded_secret_;
-    protected:
-        virtual void make_members_serializable() override {
-            blinded_secret_bytes_ = get_secbyteblock_as_byte_vector(blinded_secret_);
-        }
-        
-        virtual void deserialize_members() override {
-            blinded_secret_ = get_byte_vector_as_secbyteblock(blinded_secret_bytes_);
+            message_type_ = message_id;
         }
+        byte_view_t blinded_secret_;
 
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
+        virtual size_t encoded_length_() const override {
+            return find_message::encoded_length_() + wire_blob_length(blinded_secret_.size());
         }
 
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
+        virtual void encode_(wire_writer& _writer) const override {
+            find_message::encode_(_writer);
+            _writer.append_blob(blinded_secret_);
         }
-    private:
-        // Serializable members
-        std::vector<unsigned char> blinded_secret_bytes_;
-        // Serialization
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<find_message>(*this);
-            ar & blinded_secret_bytes_;
+
+        virtual void decode_(wire_reader& _reader) override {
+            find_message::decode_(_reader);
+            _reader.next_blob(blinded_secret_);
         }
 };
 
 struct response_message : offer_message {
     public:
+        static constexpr size_t new_sponsor_endpoint_offset = offer_message::fixed_length;
+        static constexpr size_t new_sponsor_assigned_id_offset = new_sponsor_endpoint_offset + WIRE_IPV4_ENDPOINT_SIZE;
+        static constexpr size_t fixed_length = new_sponsor_assigned_id_offset + sizeof(member_id_t);
+        static constexpr message_id_t message_id = message_type::RESPONSE;
         response_message() {
-            message_type_ = message_type::RESPONSE;
+            message_type_ = message_id;
         }
-        blinded_secret_t blinded_sponsor_secret_;
-        blinded_secret_t blinded_group_secret_;
+        byte_view_t blinded_sponsor_secret_;
+        byte_view_t blinded_group_secret_;
         struct new_sponsor {
             public:
-                boost::asio::ip::address ip_address_;
-                unsigned short port_;
+                boost::asio::ip::udp::endpoint endpoint_;
                 member_id_t assigned_id_;
-                blinded_secret_t blinded_secret_;
-            private:
-                // Serializable members
-                friend class response_message;
-                std::vector<unsigned char> ip_address_bytes_;
-                std::vector<unsigned char> blinded_secret_bytes_;
+                byte_view_t blinded_secret_;
         } new_sponsor;
-    protected:
-        virtual void make_members_serializable() override {
-            blinded_sponsor_secret_bytes_ = get_secbyteblock_as_byte_vector(blinded_sponsor_secret_);
-            blinded_group_secret_bytes_ = get_secbyteblock_as_byte_vector(blinded_group_secret_);
-            new_sponsor.ip_address_bytes_ = get_ipv4_address_as_byte_vector(new_sponsor.ip_address_.to_v4());
-            new_sponsor.blinded_secret_bytes_ = get_secbyteblock_as_byte_vector(new_sponsor.blinded_secret_);
-        }
-
-        virtual void deserialize_members() override {
-            blinded_sponsor_secret_ = get_byte_vector_as_secbyteblock(blinded_sponsor_secret_bytes_);
-            blinded_group_secret_ = get_byte_vector_as_secbyteblock(blinded_group_secret_bytes_);
-            new_sponsor.ip_address_ = get_byte_vector_as_ipv4_address(new_sponsor.ip_address_bytes_);
-            new_sponsor.blinded_secret_ = get_byte_vector_as_secbyteblock(new_sponsor.blinded_secret_bytes_);
-        }
-        
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
-        }
-
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
-        }
-    private:
-        // Serializable members
-        std::vector<unsigned char> blinded_sponsor_secret_bytes_;
-        std::vector<unsigned char> blinded_group_secret_bytes_;
-        // Serialization
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<offer_message>(*this);
-            ar & blinded_sponsor_secret_bytes_;
-            ar & blinded_group_secret_bytes_;
-            ar & new_sponsor.ip_address_bytes_;
-            ar & new_sponsor.port_;
-            ar & new_sponsor.assigned_id_;
-            ar & new_sponsor.blinded_secret_bytes_;
+
+        virtual size_t fixed_length_() const override {
+            return fixed_length;
+        }
+
+        virtual size_t encoded_length_() const override {
+            return offer_message::encoded_length_() + wire_blob_length(blinded_sponsor_secret_.size())
+                 + wire_blob_length(blinded_group_secret_.size()) + wire_blob_length(new_sponsor.blinded_secret_.size());
+        }
+
+        virtual void encode_(wire_writer& _writer) const override {
+            offer_message::encode_(_writer);
+            _writer.write_endpoint(new_sponsor_endpoint_offset, new_sponsor.endpoint_);
+            _writer.write<member_id_t>(new_sponsor_assigned_id_offset, new_sponsor.assigned_id_);
+            _writer.append_blob(blinded_sponsor_secret_);
+            _writer.append_blob(blinded_group_secret_);
+            _writer.append_blob(new_sponsor.blinded_secret_);
+        }
+
+        virtual void decode_(wire_reader& _reader) override {
+            offer_message::decode_(_reader);
+            new_sponsor.endpoint_ = _reader.read_endpoint(new_sponsor_endpoint_offset);
+            new_sponsor.assigned_id_ = _reader.read<member_id_t>(new_sponsor_assigned_id_offset);
+            _reader.next_blob(blinded_sponsor_secret_);
+            _reader.next_blob(blinded_group_secret_);
+            _reader.next_blob(new_sponsor.blinded_secret_);
         }
 };
 
 struct member_info_request_message : find_message {
     public:
+        static constexpr message_id_t message_id = message_type::MEMBER_INFO_REQUEST;
         member_info_request_message() {
-            message_type_ = message_type::MEMBER_INFO_REQUEST;
+            message_type_ = message_id;
         }
-        std::vector<member_id_t> requested_members_;
-    protected:
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
+        wire_bitmap_view<member_id_t> requested_members_;
+
+        virtual size_t encoded_length_() const override {
+            return find_message::encoded_length_() + wire_bitmap_length<member_id_t>(requested_members_.bits().size());
         }
 
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
+        virtual void encode_(wire_writer& _writer) const override {
+            find_message::encode_(_writer);
+            _writer.append_bitmap(requested_members_);
         }
-    private:
-        // Serialization
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<find_message>(*this);
-            ar & requested_members_;
+
+        virtual void decode_(wire_reader& _reader) override {
+            find_message::decode_(_reader);
+            _reader.next_bitmap(requested_members_);
         }
 };
 
 struct member_info_response_message : offer_message {
     public:
+        static constexpr size_t member_id_offset = offer_message::fixed_length;
+        static constexpr size_t fixed_length = member_id_offset + sizeof(member_id_t);
+        static constexpr message_id_t message_id = message_type::MEMBER_INFO_RESPONSE;
         member_info_response_message() {
-            message_type_ = message_type::MEMBER_INFO_RESPONSE;
+            message_type_ = message_id;
         }
         member_id_t member_id_;
-        blinded_secret_t blinded_secret_;
-    protected:
-        virtual void make_members_serializable() override {
-            blinded_secret_bytes_ = get_secbyteblock_as_byte_vector(blinded_secret_);
-        }
+        byte_view_t blinded_secret_;
 
-        virtual void deserialize_members() override {
-            blinded_secret_ = get_byte_vector_as_secbyteblock(blinded_secret_bytes_);
+        virtual size_t fixed_length_() const override {
+            return fixed_length;
         }
 
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
+        virtual size_t encoded_length_() const override {
+            return offer_message::encoded_length_() + wire_blob_length(blinded_secret_.size());
         }
 
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
+        virtual void encode_(wire_writer& _writer) const override {
+            offer_message::encode_(_writer);
+            _writer.write<member_id_t>(member_id_offset, member_id_);
+            _writer.append_blob(blinded_secret_);
         }
-    private:
-        // Serializable members
-        std::vector<unsigned char> blinded_secret_bytes_;
-        // Serialization
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<offer_message>(*this);
-            ar & member_id_;
-            ar & blinded_secret_bytes_;
+
+        virtual void decode_(wire_reader& _reader) override {
+            offer_message::decode_(_reader);
+            member_id_ = _reader.read<member_id_t>(member_id_offset);
+            _reader.next_blob(blinded_secret_);
         }
 };
 
 struct synch_token_message : message {
     public:
+        // The member the token is passed to, encoded in the header
+        static constexpr size_t member_id_offset = message::target_member_id_offset;
+        static constexpr size_t fixed_length = message::fixed_length;
+        static constexpr message_id_t message_id = message_type::SYNCH_TOKEN;
         synch_token_message() {
-            message_type_ = message_type::SYNCH_TOKEN;
+            message_type_ = message_id;
         }
         member_id_t member_id_;
-    protected:
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
-        }
 
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
+        virtual member_id_t target_member_id_() const override {
+            return member_id_;
         }
-    private:
-        // Serialization
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<message>(*this);
-            ar & member_id_;
+
+        virtual void decode_(wire_reader& _reader) override {
+            message::decode_(_reader);
+            member_id_ = _reader.read<member_id_t>(member_id_offset);
         }
 };
 
 struct member_info_synch_request_message : member_info_request_message {
     public:
+        static constexpr message_id_t message_id = message_type::MEMBER_INFO_SYNCH_REQUEST;
         member_info_synch_request_message() {
-            message_type_ = message_type::MEMBER_INFO_SYNCH_REQUEST;
+            message_type_ = message_id;
         }
 };
 
 struct member_info_synch_response_message : member_info_response_message {
     public:
+        static constexpr message_id_t message_id = message_type::MEMBER_INFO_SYNCH_RESPONSE;
         member_info_synch_response_message() {
-            message_type_ = message_type::MEMBER_INFO_SYNCH_RESPONSE;
+            message_type_ = message_id;
         }
 };
 
 struct distributed_response_message : offer_message {
     public:
+        static constexpr message_id_t message_id = message_type::DISTRIBUTED_RESPONSE;
         distributed_response_message() {
-            message_type_ = message_type::DISTRIBUTED_RESPONSE;
-        }
-        blinded_secret_t blinded_sponsor_secret_;
-        secret_t encrypted_group_secret_;
-        std::vector<unsigned char> initialization_vector_;
-    protected:
-        virtual void make_members_serializable() override {
-            blinded_sponsor_secret_bytes_ = get_secbyteblock_as_byte_vector(blinded_sponsor_secret_);
-            encrypted_group_secret_bytes_ = get_secbyteblock_as_byte_vector(encrypted_group_secret_);
-        }
-
-        virtual void deserialize_members() override {
-            blinded_sponsor_secret_ = get_byte_vector_as_secbyteblock(blinded_sponsor_secret_bytes_);
-            encrypted_group_secret_ = get_byte_vector_as_secbyteblock(encrypted_group_secret_bytes_);
-        }
-        
-        virtual void write_to_archive(boost::archive::binary_oarchive& _oarchive) override {
-            _oarchive << *this;
-        }
-
-        virtual void read_from_archive(boost::archive::binary_iarchive& _iarchive) override {
-            _iarchive >> *this;
-        }
-    private:
-        // Serializable members
-        std::vector<unsigned char> blinded_sponsor_secret_bytes_;
-        std::vector<unsigned char> encrypted_group_secret_bytes_;
-        // Serialization
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & boost::serialization::base_object<offer_message>(*this);
-            ar & blinded_sponsor_secret_bytes_;
-            ar & encrypted_group_secret_bytes_;
-            ar & initialization_vector_;
+            message_type_ = message_id;
+        }
+        byte_view_t blinded_sponsor_secret_;
+        byte_view_t encrypted_group_secret_;
+        byte_view_t initialization_vector_;
+
+        virtual size_t encoded_length_() const override {
+            return offer_message::encoded_length_() + wire_blob_length(blinded_sponsor_secret_.size())
+                 + wire_blob_length(encrypted_group_secret_.size()) + wire_blob_length(initialization_vector_.size());
+        }
+
+        virtual void encode_(wire_writer& _writer) const override {
+            offer_message::encode_(_writer);
+            _writer.append_blob(blinded_sponsor_secret_);
+            _writer.append_blob(encrypted_group_secret_);
+            _writer.append_blob(initialization_vector_);
+        }
+
+        virtual void decode_(wire_reader& _reader) override {
+            offer_message::decode_(_reader);
+            _reader.next_blob(blinded_sponsor_secret_);
+            _reader.next_blob(encrypted_group_secret_);
+            _reader.next_blob(initialization_vector_);
         }
 };
 
 struct finish_message : message {
     public:
+        static constexpr message_id_t message_id = message_type::FINISH;
         finish_message() {
-            message_type_ = message_type::FINISH;
+            message_type_ = message_id;
         }
 };
 
 struct finish_ack_message : message {
     public:
+        static constexpr message_id_t message_id = message_type::FINISH_ACK;
         finish_ack_message() {
-            message_type_ = message_type::FINISH_ACK;
+            message_type_ = message_id;
+        }
+};
+
+// Blinded key of an inner node of a key tree, multicast by the node's sponsor
+struct blinded_key_message : offer_message {
+    public:
+        static constexpr size_t node_id_offset = offer_message::fixed_length;
+        static constexpr size_t fixed_length = node_id_offset + sizeof(node_id_t);
+        static constexpr message_id_t message_id = message_type::BLINDED_KEY;
+        blinded_key_message() {
+            message_type_ = message_id;
+        }
+        node_id_t node_id_;
+        byte_view_t blinded_key_;
+
+        virtual size_t fixed_length_() const override {
+            return fixed_length;
+        }
+
+        virtual size_t encoded_length_() const override {
+            return offer_message::encoded_length_() + wire_blob_length(blinded_key_.size());
+        }
+
+        virtual void encode_(wire_writer& _writer) const override {
+            offer_message::encode_(_writer);
+            _writer.write<node_id_t>(node_id_offset, node_id_);
+            _writer.append_blob(blinded_key_);
+        }
+
+        virtual void decode_(wire_reader& _reader) override {
+            offer_message::decode_(_reader);
+            node_id_ = _reader.read<node_id_t>(node_id_offset);
+            _reader.next_blob(blinded_key_);
         }
 };
 
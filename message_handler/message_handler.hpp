@@ -3,32 +3,98 @@
 
 #include "key_agreement_protocol.hpp"
 
-#include <mutex>
+#include <array>
 
+// Maps each message type to the process_* method of the protocol
+template <typename T> void process_message(T& _protocol, const find_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_find(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const offer_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_offer(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const request_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_request(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const response_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_response(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const member_info_request_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_member_info_request(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const member_info_response_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_member_info_response(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const synch_token_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_synch_token(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const member_info_synch_request_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_member_info_synch_request(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const member_info_synch_response_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_member_info_synch_response(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const distributed_response_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_distributed_response(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const finish_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_finish(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const finish_ack_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_finish_ack(_message, _remote_endpoint); }
+template <typename T> void process_message(T& _protocol, const blinded_key_message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { _protocol.process_blinded_key(_message, _remote_endpoint); }
+
+template <typename T>
 class message_handler {
 // Variables
 private:
-    key_agreement_protocol* key_agreement_protocol_;
+    typedef void (*dispatch_t)(T*, byte_view_t, const boost::asio::ip::udp::endpoint&);
+    T* key_agreement_protocol_;
 // Methods
 public:
-    message_handler(key_agreement_protocol* _key_agreement_protocol);
-    ~message_handler();
-    void deserialize_and_callback(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void serialize(message& _message, boost::asio::streambuf& _buffer);
+    message_handler(T* _key_agreement_protocol) : key_agreement_protocol_(_key_agreement_protocol) {
+    }
+
+    ~message_handler() {
+    }
+
+    void deserialize_and_callback(byte_view_t _datagram, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+        // Generated from T::handled_messages_t, the entries of message types T does not handle stay empty
+        static constexpr std::array<dispatch_t, MESSAGE_TYPE_COUNT> dispatch_table = make_dispatch_table(typename T::handled_messages_t());
+        if (_datagram.size() < message::fixed_length) {
+            std::cerr << "[<message_handler>]: Datagram shorter than the message header received" << std::endl;
+            return;
+        }
+        message_header header;
+        header.message_type_ = _datagram[message::message_type_offset];
+        if (header.message_type_ >= MESSAGE_TYPE_COUNT) {
+            std::cerr << "[<message_handler>]: Unknown message type received" << std::endl;
+            return;
+        }
+        if (!dispatch_table[header.message_type_]) {
+            return;
+        }
+        if constexpr (requires (T& _protocol, const message_header& _header) { _protocol.is_relevant(_header); }) {
+            header.service_id_ = load_big_endian<service_id_t>(_datagram.data() + message::service_id_offset);
+            header.target_member_id_ = load_big_endian<member_id_t>(_datagram.data() + message::target_member_id_offset);
+            if (!key_agreement_protocol_->is_relevant(header)) {
+                return;
+            }
+        }
+        dispatch_table[header.message_type_](key_agreement_protocol_, _datagram, _remote_endpoint);
+    }
+
+    void serialize(message& _message, boost::asio::streambuf& _buffer) {
+        // Encode straight into the streambuf's output area
+        const size_t length = _message.encoded_length_();
+        wire_writer writer(static_cast<unsigned char*>(_buffer.prepare(length).data()), _message.fixed_length_());
+        _message.encode_(writer);
+        _buffer.commit(writer.encoded_length());
+    }
+
+    void serialize(const message& _message, std::vector<unsigned char>& _buffer) {
+        // Keeps the capacity of the buffer, so a recycled buffer is encoded into without allocating
+        _buffer.resize(_message.encoded_length_());
+        wire_writer writer(_buffer.data(), _message.fixed_length_());
+        _message.encode_(writer);
+        _buffer.resize(writer.encoded_length());
+    }
 private:
-    message_id_t extract_message_id(boost::asio::streambuf& buffer);
-    void process_find(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_offer(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_request(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_response(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_member_info_request(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_member_info_response(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_synch_token(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_member_info_synch_request(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_member_info_synch_response(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_distributed_response(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_finish(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-    void process_finish_ack(boost::asio::streambuf& buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
+    template <typename... M>
+    static constexpr std::array<dispatch_t, MESSAGE_TYPE_COUNT> make_dispatch_table(handled_messages<M...>) {
+        std::array<dispatch_t, MESSAGE_TYPE_COUNT> dispatch_table{};
+        ((dispatch_table[M::message_id] = &decode_and_process<M>), ...);
+        return dispatch_table;
+    }
+
+    template <typename M>
+    static void decode_and_process(T* _key_agreement_protocol, byte_view_t _datagram, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+        M rcvd_message;
+        wire_reader reader(_datagram, M::fixed_length);
+        // Qualified, the type is known here and the decoders of the bases are called non-virtually as well
+        rcvd_message.M::decode_(reader);
+        if (!reader.succeeded()) {
+            std::cerr << "[<message_handler>]: Malformed message of type " << static_cast<int>(M::message_id) << " received" << std::endl;
+            return;
+        }
+        process_message(*_key_agreement_protocol, rcvd_message, _remote_endpoint);
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
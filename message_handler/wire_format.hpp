@@ -0,0 +1,230 @@
+#ifndef WIRE_FORMAT
+#define WIRE_FORMAT
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cryptopp/secblock.h>
+#include <boost/asio/ip/udp.hpp>
+#include "primitives.hpp"
+
+// Fixed-layout wire format: every message starts with its fixed-size fields at compile-time offsets,
+// followed by its variable-size fields (byte blocks and lists), each prefixed with a 16 bit length.
+// Integers are encoded in network byte order.
+
+#define WIRE_LENGTH_PREFIX_SIZE 2
+// Endpoints are a fixed-size field of IPv4 address and port, the transport is IPv4 only.
+// An IPv6 endpoint field (16 bytes address, 2 bytes port) is reserved.
+#define WIRE_IPV4_ENDPOINT_SIZE 6
+#define WIRE_IPV6_ENDPOINT_SIZE 18
+
+template <typename T>
+static void store_big_endian(unsigned char* _data, T _value) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+        _data[i] = static_cast<unsigned char>(_value >> (8 * (sizeof(T) - 1 - i)));
+    }
+}
+
+template <typename T>
+static T load_big_endian(const unsigned char* _data) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        value = static_cast<T>((value << 8) | _data[i]);
+    }
+    return value;
+}
+
+// Length of a variable-size field holding _byte_count bytes
+static constexpr size_t wire_blob_length(size_t _byte_count) {
+    return WIRE_LENGTH_PREFIX_SIZE + _byte_count;
+}
+
+// Length of a bitmap field over _byte_count bytes of integers of type T
+template <typename T>
+static constexpr size_t wire_bitmap_length(size_t _byte_count) {
+    return sizeof(T) + wire_blob_length(_byte_count);
+}
+
+// Set of integers encoded as the smallest one followed by a bitmap, bit i (LSB first) marks first + i.
+// Built by the sender, values have to be inserted in ascending order.
+template <typename T>
+class wire_bitmap {
+// Variables
+private:
+    T first_;
+    std::vector<unsigned char> bits_;
+// Methods
+public:
+    wire_bitmap() : first_(0) {
+    }
+
+    void insert(T _value) {
+        if (bits_.empty()) {
+            first_ = _value;
+        }
+        size_t bit = static_cast<size_t>(_value - first_);
+        if (bit / 8 >= bits_.size()) {
+            bits_.resize(bit / 8 + 1);
+        }
+        bits_[bit / 8] |= static_cast<unsigned char>(1 << (bit % 8));
+    }
+
+    T first() const {
+        return first_;
+    }
+
+    byte_view_t bits() const {
+        return byte_view_t(bits_);
+    }
+};
+
+// Read-only view of a bitmap set, borrowed from a wire_bitmap when sending or pointing into a received datagram
+template <typename T>
+class wire_bitmap_view {
+// Variables
+private:
+    T first_;
+    byte_view_t bits_;
+// Methods
+public:
+    wire_bitmap_view() : first_(0) {
+    }
+
+    wire_bitmap_view(const wire_bitmap<T>& _bitmap) : first_(_bitmap.first()), bits_(_bitmap.bits()) {
+    }
+
+    // The view must not outlive the bitmap it borrows from
+    wire_bitmap_view(wire_bitmap<T>&& _bitmap) = delete;
+
+    wire_bitmap_view(T _first, byte_view_t _bits) : first_(_first), bits_(_bits) {
+    }
+
+    T first() const {
+        return first_;
+    }
+
+    byte_view_t bits() const {
+        return bits_;
+    }
+
+    bool contains(T _value) const {
+        if (_value < first_) {
+            return false;
+        }
+        size_t bit = static_cast<size_t>(_value - first_);
+        return bit / 8 < bits_.size() && (bits_[bit / 8] >> (bit % 8)) & 1;
+    }
+};
+
+// Encodes into a caller-provided buffer
+class wire_writer {
+// Variables
+private:
+    unsigned char* data_;
+    size_t offset_;
+// Methods
+public:
+    // _data must hold the message's encoded_length_() bytes
+    wire_writer(unsigned char* _data, size_t _fixed_length) : data_(_data), offset_(_fixed_length) {
+    }
+
+    template <typename T>
+    void write(size_t _offset, T _value) {
+        store_big_endian<T>(data_ + _offset, _value);
+    }
+
+    void write_endpoint(size_t _offset, const boost::asio::ip::udp::endpoint& _endpoint) {
+        write<std::uint32_t>(_offset, _endpoint.address().to_v4().to_uint());
+        write<std::uint16_t>(_offset + sizeof(std::uint32_t), _endpoint.port());
+    }
+
+    template <typename T>
+    void append(T _value) {
+        store_big_endian<T>(data_ + offset_, _value);
+        offset_ += sizeof(T);
+    }
+
+    void append_blob(byte_view_t _bytes) {
+        append<std::uint16_t>(static_cast<std::uint16_t>(_bytes.size()));
+        if (!_bytes.empty()) {
+            std::memcpy(data_ + offset_, _bytes.data(), _bytes.size());
+        }
+        offset_ += _bytes.size();
+    }
+
+    template <typename T>
+    void append_bitmap(const wire_bitmap_view<T>& _bitmap) {
+        append<T>(_bitmap.first());
+        append_blob(_bitmap.bits());
+    }
+
+    size_t encoded_length() const {
+        return offset_;
+    }
+};
+
+// Decodes straight from the received bytes, every read is bounds-checked and a violation marks the reader as failed.
+// Variable-size fields are handed out as views into the datagram, nothing is copied or allocated.
+class wire_reader {
+// Variables
+private:
+    const unsigned char* data_;
+    size_t length_;
+    size_t offset_;
+    bool failed_;
+// Methods
+public:
+    wire_reader(byte_view_t _datagram, size_t _fixed_length) : data_(_datagram.data()), length_(_datagram.size()), offset_(_fixed_length), failed_(_datagram.size() < _fixed_length) {
+    }
+
+    // Fixed-size fields are covered by the length check in the constructor
+    template <typename T>
+    T read(size_t _offset) {
+        return failed_ ? T() : load_big_endian<T>(data_ + _offset);
+    }
+
+    boost::asio::ip::udp::endpoint read_endpoint(size_t _offset) {
+        return boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4(read<std::uint32_t>(_offset)), read<std::uint16_t>(_offset + sizeof(std::uint32_t)));
+    }
+
+    template <typename T>
+    T next() {
+        if (failed_ || length_ - offset_ < sizeof(T)) {
+            failed_ = true;
+            return T();
+        }
+        T value = load_big_endian<T>(data_ + offset_);
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    void next_blob(byte_view_t& _bytes) {
+        std::uint16_t byte_count = next<std::uint16_t>();
+        if (failed_ || length_ - offset_ < byte_count) {
+            failed_ = true;
+            return;
+        }
+        _bytes = byte_view_t(data_ + offset_, byte_count);
+        offset_ += byte_count;
+    }
+
+    template <typename T>
+    void next_bitmap(wire_bitmap_view<T>& _bitmap) {
+        T first = next<T>();
+        byte_view_t bits;
+        next_blob(bits);
+        _bitmap = wire_bitmap_view<T>(first, bits);
+    }
+
+    bool failed() const {
+        return failed_;
+    }
+
+    // Trailing bytes are rejected as well, a well-formed datagram is consumed exactly
+    bool succeeded() const {
+        return !failed_ && offset_ == length_;
+    }
+};
+
+#endif
@@ -1,3 +1,4 @@
+#include <boost/algorithm/string.hpp>
 #include "logger.hpp"
 #include "multicast_application_impl.hpp"
 #include "key_agreement_protocol.hpp"
@@ -6,7 +7,9 @@
 
 class multicast_app_testframe : public key_agreement_protocol, public multicast_application_impl {
     public:
-        multicast_app_testframe(bool _is_sponsor) : is_sponsor_(_is_sponsor), multicast_application_impl(boost::asio::ip::address::from_string("127.0.0.1"), boost::asio::ip::address::from_string("239.255.0.1"), 65000), message_handler_(std::make_unique<message_handler>(this)), request_counter_(0) {
+        typedef handled_messages<offer_message, request_message> handled_messages_t;
+
+        multicast_app_testframe(bool _is_sponsor) : is_sponsor_(_is_sponsor), multicast_application_impl(boost::asio::ip::address::from_string("127.0.0.1"), boost::asio::ip::address::from_string("239.255.0.1"), 65000), message_handler_(std::make_unique<message_handler<multicast_app_testframe>>(this)), request_counter_(0) {
             if (is_sponsor_) {
                 std::unique_ptr<offer_message> offer = std::make_unique<offer_message>();
                 offer->offered_service_ = 0;
@@ -24,67 +27,27 @@ class multicast_app_testframe : public key_agreement_protocol, public multicast_
         void received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) override {
             std::lock_guard<std::mutex> lock_receive(receive_mutex_);
             if (get_local_endpoint().port() != _remote_endpoint.port()) {
-                message_handler_->deserialize_and_callback(_data, _bytes_recvd, _remote_endpoint);
+                message_handler_->deserialize_and_callback(byte_view_t(_data, _bytes_recvd), _remote_endpoint);
             }
         }
 
-        void process_find(find_message _rcvd_find_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_offer(offer_message _rcvd_offer_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
+        void process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
             std::unique_ptr<request_message> request = std::make_unique<request_message>();
             request->required_service_ = 0;
             send(request.operator*());
         }
 
-        void process_request(request_message _rcvd_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
+        void process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
             if (is_sponsor_) {
                 request_counter_++;
                 LOG_DEBUG("[<multicast_app_testframe>]: rcvd requests=" << request_counter_)
             }
         }
-
-        void process_response(response_message _rcvd_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_member_info_request(member_info_request_message _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_member_info_response(member_info_response_message _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_synch_token(synch_token_message _rcvd_synch_token_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_member_info_synch_request(member_info_synch_request_message _rcvd_member_info_synch_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_member_info_synch_response(member_info_synch_response_message _rcvd_member_info_synch_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_distributed_response(distributed_response_message _rcvd_distributed_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_finish(finish_message _rcvd_finish_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
-
-        void process_finish_ack(finish_ack_message _rcvd_finish_ack_message, boost::asio::ip::udp::endpoint _remote_endpoint) override {
-
-        }
     protected:
     private:
         bool is_sponsor_;
         uint32_t request_counter_;
-        std::unique_ptr<message_handler> message_handler_;
+        std::unique_ptr<message_handler<multicast_app_testframe>> message_handler_;
         std::mutex receive_mutex_;
 
         void send(message& _message) {
@@ -1,15 +1,20 @@
 #include <boost/algorithm/string.hpp>
 #include "logger.hpp"
+#include "command_line_flags.hpp"
 #include "str_dh.hpp"
 #include "distributed_dh.hpp"
+#include "tgdh.hpp"
 
 int main(int argc, char* argv[]) {
+  command_line_flags flags(argc, argv);
+  argc = flags.get_argc();
+  argv = flags.get_argv();
   try
   {
-    if (argc != 9)
+    if (argc < 9 || argc > 11 || !flags.is_valid())
     {
-      std::cerr << "Usage: multicast-dh-example <is_sponsor> <service_id> <member_count> <scatter_delay_min(ms)> <scatter_delay_max(ms)> <listening_interface_by_ip> <multicast_ip> <multicast_port>\n";
-      std::cerr << "  Example: multicast-dh-example true 42 20 10 100 127.0.0.1 239.255.0.1 65000\n";
+      std::cerr << "Usage: multicast-dh-example <is_sponsor> <service_id> <member_count> <scatter_delay_min(ms)> <scatter_delay_max(ms)> <listening_interface_by_ip> <multicast_ip> <multicast_port> [worker_thread_count] [send_rate(bytes/s)] " << command_line_flags::usage() << "\n";
+      std::cerr << "  Example: multicast-dh-example true 42 20 10 100 127.0.0.1 239.255.0.1 65000 4 1048576 --protocol=PROTO_DST_DH --crypto=X25519_DH\n";
       return 1;
     }
 
@@ -18,6 +23,8 @@ int main(int argc, char* argv[]) {
     std::uint32_t member_count = std::stoi(argv[3]);
     std::uint32_t scatter_delay_min = std::stoi(argv[4]);
     std::uint32_t scatter_delay_max = std::stoi(argv[5]);
+    std::uint32_t worker_thread_count = argc >= 10 ? std::stoi(argv[9]) : 1;
+    std::uint32_t send_rate = argc == 11 ? std::stoul(argv[10]) : 0;
 
     boost::system::error_code ec;
     boost::asio::ip::address listening_interface_by_ip = boost::asio::ip::address::from_string(argv[6], ec);
@@ -37,8 +44,8 @@ int main(int argc, char* argv[]) {
       return 1;
     }
 
-    if (service_id < 1) {
-      std::cerr << "service id must be greater than 0\n";
+    if (service_id < 1 || service_id >= ANY_SERVICE_ID) {
+      std::cerr << "service id must be between 1 and " << ANY_SERVICE_ID - 1 << ", " << ANY_SERVICE_ID << " is reserved for messages of any service\n";
       return 1;      
     }
 
@@ -47,12 +54,25 @@ int main(int argc, char* argv[]) {
       return 1;
     }
 
-#ifdef PROTO_STR_DH
-    str_dh _member(boost::iequals(is_sponsor, "true"), service_id, member_count, scatter_delay_min, scatter_delay_max, listening_interface_by_ip, multicast_ip, std::stoi(argv[8]));
-#elif defined(PROTO_DST_DH)
-    distributed_dh _member(boost::iequals(is_sponsor, "true"), service_id, member_count, scatter_delay_min, scatter_delay_max, listening_interface_by_ip, multicast_ip, std::stoi(argv[8]));
-#endif
-    _member.start();
+    if (worker_thread_count < 1) {
+      std::cerr << "worker thread count must be greater than 0\n";
+      return 1;
+    }
+
+    // Protocol and crypto group are picked once here, the member itself is specialized for its group at compile time
+    with_crypto_group(flags.get_crypto_algorithm(), [&](auto _group) {
+      typedef decltype(_group) group_t;
+      if (flags.get_protocol() == "PROTO_STR_DH") {
+        str_dh<group_t> _member(boost::iequals(is_sponsor, "true"), service_id, member_count, scatter_delay_min, scatter_delay_max, listening_interface_by_ip, multicast_ip, std::stoi(argv[8]), worker_thread_count, send_rate);
+        _member.start();
+      } else if (flags.get_protocol() == "PROTO_DST_DH") {
+        distributed_dh<group_t> _member(boost::iequals(is_sponsor, "true"), service_id, member_count, scatter_delay_min, scatter_delay_max, listening_interface_by_ip, multicast_ip, std::stoi(argv[8]), worker_thread_count, send_rate);
+        _member.start();
+      } else {
+        tgdh<group_t> _member(boost::iequals(is_sponsor, "true"), service_id, member_count, scatter_delay_min, scatter_delay_max, listening_interface_by_ip, multicast_ip, std::stoi(argv[8]), worker_thread_count, send_rate);
+        _member.start();
+      }
+    });
   }
   catch (std::exception& e)
   {
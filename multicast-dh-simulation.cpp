@@ -0,0 +1,89 @@
+#include <boost/algorithm/string.hpp>
+#include <type_traits>
+#include "logger.hpp"
+#include "command_line_flags.hpp"
+#include "in_memory_bus.hpp"
+#include "str_dh.hpp"
+#include "distributed_dh.hpp"
+#include "tgdh.hpp"
+
+int main(int argc, char* argv[]) {
+  command_line_flags flags(argc, argv);
+  argc = flags.get_argc();
+  argv = flags.get_argv();
+  try
+  {
+    if ((argc != 8 && argc != 9) || !flags.is_valid())
+    {
+      std::cerr << "Usage: multicast-dh-simulation <service_id> <member_count> <scatter_delay_min(ms)> <scatter_delay_max(ms)> <listening_interface_by_ip> <multicast_ip> <multicast_port> [worker_thread_count] " << command_line_flags::usage() << "\n";
+      std::cerr << "  Example: multicast-dh-simulation 42 2000 10 100 127.0.0.1 239.255.0.1 65000 4 --protocol=PROTO_DST_DH --crypto=X25519_DH\n";
+      return 1;
+    }
+
+    std::uint32_t service_id = std::stoi(argv[1]);
+    std::uint32_t member_count = std::stoi(argv[2]);
+    std::uint32_t scatter_delay_min = std::stoi(argv[3]);
+    std::uint32_t scatter_delay_max = std::stoi(argv[4]);
+    std::uint16_t multicast_port = std::stoi(argv[7]);
+    std::uint32_t worker_thread_count = argc == 9 ? std::stoi(argv[8]) : 1;
+
+    boost::system::error_code ec;
+    boost::asio::ip::address listening_interface_by_ip = boost::asio::ip::address::from_string(argv[5], ec);
+    if (ec) {
+        std::cerr << ec.what() << std::endl;
+        return 1;
+    }
+
+    boost::asio::ip::address multicast_ip = boost::asio::ip::address::from_string(argv[6], ec);
+    if (ec) {
+        std::cerr << ec.what() << std::endl;
+        return 1;
+    }
+
+    if (service_id < 1 || service_id >= ANY_SERVICE_ID) {
+      std::cerr << "service id must be between 1 and " << ANY_SERVICE_ID - 1 << ", " << ANY_SERVICE_ID << " is reserved for messages of any service\n";
+      return 1;      
+    }
+
+    if (member_count < 2) {
+      std::cerr << "member count must be greater than 1\n";
+      return 1;
+    }
+
+    if (worker_thread_count < 1) {
+      std::cerr << "worker thread count must be greater than 0\n";
+      return 1;
+    }
+
+    auto simulate = [&](auto _protocol) {
+      typedef typename decltype(_protocol)::type protocol_t;
+      // All members share one process and one io_service, datagrams are exchanged through the bus instead of UDP sockets
+      in_memory_bus bus;
+      std::vector<std::unique_ptr<protocol_t>> members;
+      // Subscribers first, so that they are attached when the initial sponsor sends its offer
+      for (std::uint32_t i = 0; i < member_count; i++) {
+        bool is_sponsor = i == member_count-1;
+        members.push_back(std::make_unique<protocol_t>(is_sponsor, service_id, member_count, scatter_delay_min, scatter_delay_max, listening_interface_by_ip, multicast_ip, multicast_port, worker_thread_count, 0, &bus));
+      }
+      LOG_STD("[<multicast-dh-simulation>]: " << member_count << " members attached")
+      bus.run(worker_thread_count);
+    };
+    // Protocol and crypto group are picked once here, the members themselves are specialized for their group at compile time
+    with_crypto_group(flags.get_crypto_algorithm(), [&](auto _group) {
+      typedef decltype(_group) group_t;
+      if (flags.get_protocol() == "PROTO_STR_DH") {
+        simulate(std::type_identity<str_dh<group_t>>());
+      } else if (flags.get_protocol() == "PROTO_DST_DH") {
+        simulate(std::type_identity<distributed_dh<group_t>>());
+      } else {
+        simulate(std::type_identity<tgdh<group_t>>());
+      }
+    });
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Exception: " << e.what() << "\n";
+  }
+
+  return 0;
+}
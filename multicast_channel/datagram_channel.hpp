@@ -0,0 +1,37 @@
+#ifndef DATAGRAM_CHANNEL
+#define DATAGRAM_CHANNEL
+
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <boost/asio.hpp>
+
+// Immutable serialized datagram, shared between the sender's cache and any sends still in flight
+typedef std::shared_ptr<const std::vector<unsigned char>> shared_datagram_t;
+
+inline shared_datagram_t make_shared_datagram(const boost::asio::streambuf& _buffer) {
+    const unsigned char* data = static_cast<const unsigned char*>(_buffer.data().data());
+    return std::make_shared<const std::vector<unsigned char>>(data, data + _buffer.size());
+}
+
+// Kernel drops and socket queue high-water marks (bytes) as seen by one member
+struct transport_statistics {
+    std::uint64_t kernel_drops_ = 0;
+    std::uint64_t receive_queue_high_water_mark_ = 0;
+    std::uint64_t send_queue_high_water_mark_ = 0;
+};
+
+class datagram_channel {
+private:
+
+public:
+    virtual ~datagram_channel() {}
+    virtual void send_multicast(boost::asio::streambuf& _buffer) = 0;
+    virtual void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
+    virtual void send_multicast(shared_datagram_t _datagram) = 0;
+    virtual void send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) = 0;
+    virtual boost::asio::ip::udp::endpoint get_local_endpoint() const = 0;
+    virtual transport_statistics get_transport_statistics() const { return transport_statistics(); }
+};
+
+#endif
@@ -0,0 +1,171 @@
+#include "fragmenting_channel.hpp"
+#include "logger.hpp"
+
+fragmenting_channel::fragmenting_channel(multicast_application& _mc_app) : mc_app_(_mc_app), next_message_id_(0) {
+}
+
+fragmenting_channel::~fragmenting_channel() {
+}
+
+void fragmenting_channel::set_datagram_channel(std::unique_ptr<datagram_channel> _datagram_channel) {
+  datagram_channel_ = std::move(_datagram_channel);
+}
+
+void fragmenting_channel::send_multicast(boost::asio::streambuf& _buffer) {
+  if (_buffer.size() <= max_fragment_length) {
+    datagram_channel_->send_multicast(_buffer);
+    return;
+  }
+  for (shared_datagram_t fragment : fragment(static_cast<const unsigned char*>(_buffer.data().data()), _buffer.size())) {
+    datagram_channel_->send_multicast(fragment);
+  }
+}
+
+void fragmenting_channel::send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  if (_buffer.size() <= max_fragment_length) {
+    datagram_channel_->send_to(_buffer, _remote_endpoint);
+    return;
+  }
+  for (shared_datagram_t fragment : fragment(static_cast<const unsigned char*>(_buffer.data().data()), _buffer.size())) {
+    datagram_channel_->send_to(fragment, _remote_endpoint);
+  }
+}
+
+void fragmenting_channel::send_multicast(shared_datagram_t _datagram) {
+  if (_datagram->size() <= max_fragment_length) {
+    datagram_channel_->send_multicast(_datagram);
+    return;
+  }
+  for (const shared_datagram_t& fragment : cached_fragments(_datagram)) {
+    datagram_channel_->send_multicast(fragment);
+  }
+}
+
+void fragmenting_channel::send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  if (_datagram->size() <= max_fragment_length) {
+    datagram_channel_->send_to(_datagram, _remote_endpoint);
+    return;
+  }
+  for (const shared_datagram_t& fragment : cached_fragments(_datagram)) {
+    datagram_channel_->send_to(fragment, _remote_endpoint);
+  }
+}
+
+boost::asio::ip::udp::endpoint fragmenting_channel::get_local_endpoint() const {
+  return datagram_channel_->get_local_endpoint();
+}
+
+transport_statistics fragmenting_channel::get_transport_statistics() const {
+  return datagram_channel_->get_transport_statistics();
+}
+
+std::vector<shared_datagram_t> fragmenting_channel::fragment(const unsigned char* _data, size_t _length) {
+  const size_t max_payload_length = max_fragment_length - fragment_header_length;
+  const size_t fragment_count = (_length + max_payload_length - 1) / max_payload_length;
+  std::vector<shared_datagram_t> fragments;
+  if (fragment_count > max_fragment_count) {
+    std::cerr << "[<fragmenting_channel>]: (fragment) datagram of " << _length << " bytes exceeds the maximum of " << max_datagram_length << " bytes" << std::endl;
+    return fragments;
+  }
+  const std::uint32_t message_id = next_message_id_++;
+  fragments.reserve(fragment_count);
+  for (size_t index = 0; index < fragment_count; index++) {
+    const size_t offset = index * max_payload_length;
+    const size_t payload_length = std::min(max_payload_length, _length - offset);
+    std::vector<unsigned char> fragment(fragment_header_length + payload_length);
+    // Header fields are written in network byte order
+    fragment[0] = FRAGMENT_MARKER;
+    fragment[1] = message_id >> 24; fragment[2] = message_id >> 16; fragment[3] = message_id >> 8; fragment[4] = message_id;
+    fragment[5] = index >> 8; fragment[6] = index;
+    fragment[7] = fragment_count >> 8; fragment[8] = fragment_count;
+    std::copy(_data + offset, _data + offset + payload_length, fragment.begin() + fragment_header_length);
+    fragments.push_back(std::make_shared<const std::vector<unsigned char>>(std::move(fragment)));
+  }
+  return fragments;
+}
+
+const std::vector<shared_datagram_t>& fragmenting_channel::cached_fragments(shared_datagram_t _datagram) {
+  std::deque<fragmentation>::iterator cached = std::find_if(fragmentations_.begin(), fragmentations_.end(), [&_datagram](const fragmentation& _fragmentation) {
+    return _fragmentation.datagram_.lock() == _datagram;
+  });
+  if (cached != fragmentations_.end()) {
+    // Pooled send buffers are reused for other messages once sent, so the bytes are compared as well
+    if (!carries(cached->fragments_, *_datagram)) {
+      cached->fragments_ = fragment(_datagram->data(), _datagram->size());
+    }
+    return cached->fragments_;
+  }
+  std::erase_if(fragmentations_, [](const fragmentation& _fragmentation) {
+    return _fragmentation.datagram_.expired();
+  });
+  if (fragmentations_.size() >= max_cached_fragmentations) {
+    fragmentations_.pop_front();
+  }
+  fragmentations_.push_back(fragmentation{_datagram, fragment(_datagram->data(), _datagram->size())});
+  return fragmentations_.back().fragments_;
+}
+
+bool fragmenting_channel::carries(const std::vector<shared_datagram_t>& _fragments, const std::vector<unsigned char>& _datagram) {
+  size_t offset = 0;
+  for (const shared_datagram_t& fragment : _fragments) {
+    const size_t payload_length = fragment->size() - fragment_header_length;
+    if (offset + payload_length > _datagram.size() || !std::equal(fragment->begin() + fragment_header_length, fragment->end(), _datagram.begin() + offset)) {
+      return false;
+    }
+    offset += payload_length;
+  }
+  return offset == _datagram.size();
+}
+
+void fragmenting_channel::received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  if (_bytes_recvd == 0 || _data[0] != FRAGMENT_MARKER) {
+    mc_app_.received_data(_data, _bytes_recvd, _remote_endpoint);
+    return;
+  }
+  if (_bytes_recvd <= fragment_header_length) {
+    std::cerr << "[<fragmenting_channel>]: (received_data) truncated fragment from " << _remote_endpoint << std::endl;
+    return;
+  }
+  const std::uint32_t message_id = (std::uint32_t(_data[1]) << 24) | (std::uint32_t(_data[2]) << 16) | (std::uint32_t(_data[3]) << 8) | _data[4];
+  const std::uint16_t index = (std::uint16_t(_data[5]) << 8) | _data[6];
+  const std::uint16_t fragment_count = (std::uint16_t(_data[7]) << 8) | _data[8];
+  if (index >= fragment_count) {
+    std::cerr << "[<fragmenting_channel>]: (received_data) invalid fragment index from " << _remote_endpoint << std::endl;
+    return;
+  }
+  if (fragment_count > max_fragment_count) {
+    std::cerr << "[<fragmenting_channel>]: (received_data) fragment count " << fragment_count << " above the maximum from " << _remote_endpoint << std::endl;
+    return;
+  }
+  const reassembly_key_t key(_remote_endpoint, message_id);
+  std::map<reassembly_key_t, reassembly>::iterator itr = reassemblies_.find(key);
+  if (itr == reassemblies_.end()) {
+    if (reassembly_order_.size() >= max_pending_reassemblies) {
+      reassemblies_.erase(reassembly_order_.front());
+      reassembly_order_.pop_front();
+    }
+    reassembly_order_.push_back(key);
+    itr = reassemblies_.emplace(key, reassembly{std::vector<std::vector<unsigned char>>(fragment_count), 0, std::prev(reassembly_order_.end())}).first;
+  }
+  reassembly& pending = itr->second;
+  if (pending.fragments_.size() != fragment_count) {
+    std::cerr << "[<fragmenting_channel>]: (received_data) inconsistent fragment count from " << _remote_endpoint << std::endl;
+    return;
+  }
+  if (!pending.fragments_[index].empty()) {
+    // Duplicate
+    return;
+  }
+  pending.fragments_[index].assign(_data + fragment_header_length, _data + _bytes_recvd);
+  if (++pending.fragments_rcvd_ < fragment_count) {
+    return;
+  }
+  std::vector<unsigned char> datagram;
+  for (std::vector<unsigned char>& fragment : pending.fragments_) {
+    datagram.insert(datagram.end(), fragment.begin(), fragment.end());
+  }
+  // Otherwise a later reassembly of the same key (a retransmission) would be queued twice and evicted by the stale entry
+  reassembly_order_.erase(pending.order_);
+  reassemblies_.erase(itr);
+  mc_app_.received_data(datagram.data(), datagram.size(), _remote_endpoint);
+}
@@ -0,0 +1,70 @@
+#ifndef FRAGMENTING_CHANNEL
+#define FRAGMENTING_CHANNEL
+
+#include "multicast_application.hpp"
+#include "datagram_channel.hpp"
+
+#include <algorithm>
+#include <map>
+#include <deque>
+#include <list>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#define FRAGMENT_MARKER 0xFF
+
+// Splits datagrams above the path MTU into fragments and reassembles them before they reach the application.
+// Fragment layout: FRAGMENT_MARKER (1 byte), message id (4 bytes), fragment index (2 bytes), fragment count (2 bytes), payload.
+// Datagrams that fit into one fragment are passed through unchanged, their first byte is always a message type.
+class fragmenting_channel : public datagram_channel, public multicast_application
+{
+
+private:
+/* Member variables*/
+  // Ethernet MTU minus IPv4 and UDP headers, so no datagram is fragmented on the IP layer
+  enum { max_fragment_length = 1472, fragment_header_length = 9, max_pending_reassemblies = 1024, max_cached_fragmentations = 64 };
+  // Largest datagram the protocols produce (a member bitmap of 65535 members is 8 KiB), fragments announcing a larger
+  // count are dropped, so a forged header cannot make the receiver allocate slots for 65535 fragments
+  enum { max_datagram_length = 65536, max_fragment_count = (max_datagram_length + max_fragment_length - fragment_header_length - 1) / (max_fragment_length - fragment_header_length) };
+  struct fragmentation {
+    std::weak_ptr<const std::vector<unsigned char>> datagram_;
+    std::vector<shared_datagram_t> fragments_;
+  };
+  typedef std::pair<boost::asio::ip::udp::endpoint, std::uint32_t> reassembly_key_t;
+  struct reassembly {
+    std::vector<std::vector<unsigned char>> fragments_;
+    std::uint16_t fragments_rcvd_;
+    // Position in reassembly_order_, so a completed reassembly is unlinked in constant time
+    std::list<reassembly_key_t>::iterator order_;
+  };
+  multicast_application& mc_app_;
+  std::unique_ptr<datagram_channel> datagram_channel_;
+  std::uint32_t next_message_id_;
+  std::map<reassembly_key_t, reassembly> reassemblies_;
+  // Incomplete reassemblies are evicted oldest first, lost fragments are recovered by the protocol's retransmissions
+  std::list<reassembly_key_t> reassembly_order_;
+  // Fragments of the last oversized shared datagrams sent, so resending a cached datagram resends the same fragments
+  // (and message id) without fragmenting it again. Receivers that lost some fragments complete their reassembly with them.
+  std::deque<fragmentation> fragmentations_;
+
+private:
+/* Methods */
+  std::vector<shared_datagram_t> fragment(const unsigned char* _data, size_t _length);
+  const std::vector<shared_datagram_t>& cached_fragments(shared_datagram_t _datagram);
+  static bool carries(const std::vector<shared_datagram_t>& _fragments, const std::vector<unsigned char>& _datagram);
+
+public:
+  fragmenting_channel(multicast_application& _mc_app);
+  ~fragmenting_channel();
+  // The wrapped channel must deliver its datagrams to this fragmenting_channel
+  void set_datagram_channel(std::unique_ptr<datagram_channel> _datagram_channel);
+  void send_multicast(boost::asio::streambuf& _buffer) override;
+  void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  void send_multicast(shared_datagram_t _datagram) override;
+  void send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  boost::asio::ip::udp::endpoint get_local_endpoint() const override;
+  transport_statistics get_transport_statistics() const override;
+  void received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+};
+#endif
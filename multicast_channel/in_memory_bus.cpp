@@ -0,0 +1,101 @@
+#include "in_memory_bus.hpp"
+#include "logger.hpp"
+
+#include <thread>
+
+in_memory_bus::in_memory_bus() : next_port_(IN_MEMORY_BUS_FIRST_PORT) {
+}
+
+in_memory_bus::~in_memory_bus() {
+}
+
+boost::asio::io_service& in_memory_bus::get_io_service() {
+    return io_service_;
+}
+
+boost::asio::ip::udp::endpoint in_memory_bus::attach(boost::asio::ip::address _listening_interface_by_address, boost::asio::ip::udp::endpoint _multicast_endpoint,
+                                                     boost::asio::strand<boost::asio::io_service::executor_type>& _strand, multicast_application& _mc_app) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (next_port_ > UINT16_MAX) {
+        throw std::runtime_error("[<in_memory_bus>]: (attach) no unicast ports left");
+    }
+    boost::asio::ip::udp::endpoint local_endpoint(_listening_interface_by_address, next_port_++);
+    if (local_endpoint.port() == _multicast_endpoint.port() && next_port_ <= UINT16_MAX) {
+        local_endpoint.port(next_port_++);
+    }
+    members_[local_endpoint] = {&_strand, &_mc_app, _multicast_endpoint, std::make_shared<std::atomic<bool>>(true)};
+    return local_endpoint;
+}
+
+void in_memory_bus::detach(boost::asio::ip::udp::endpoint _local_endpoint) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    std::unordered_map<boost::asio::ip::udp::endpoint, member>::iterator detached_member = members_.find(_local_endpoint);
+    if (detached_member == members_.end()) {
+        return;
+    }
+    detached_member->second.attached_->store(false, std::memory_order_release);
+    members_.erase(detached_member);
+    if (members_.empty()) {
+        LOG_STD("[<in_memory_bus>]: all members detached")
+        io_service_.stop();
+    }
+}
+
+void in_memory_bus::send_multicast(boost::asio::ip::udp::endpoint _local_endpoint, boost::asio::ip::udp::endpoint _multicast_endpoint, shared_datagram_t _datagram) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!members_.contains(_local_endpoint)) {
+        return;
+    }
+    for (const std::pair<const boost::asio::ip::udp::endpoint, member>& receiver : members_) {
+        if (receiver.first != _local_endpoint && receiver.second.multicast_endpoint_ == _multicast_endpoint) {
+            deliver(receiver.second, _datagram, _local_endpoint);
+        }
+    }
+}
+
+void in_memory_bus::send_to(boost::asio::ip::udp::endpoint _local_endpoint, boost::asio::ip::udp::endpoint _remote_endpoint, shared_datagram_t _datagram) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!members_.contains(_local_endpoint)) {
+        return;
+    }
+    std::unordered_map<boost::asio::ip::udp::endpoint, member>::iterator receiver = members_.find(_remote_endpoint);
+    if (receiver != members_.end()) {
+        deliver(receiver->second, _datagram, _local_endpoint);
+    }
+}
+
+void in_memory_bus::deliver(const member& _member, shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) {
+    multicast_application* mc_app = _member.mc_app_;
+    boost::asio::post(*_member.strand_, [mc_app, attached = _member.attached_, _datagram, _remote_endpoint]() {
+        // Datagrams still in flight are dropped once the receiver has been detached, like on a closed socket.
+        // Members detach from their own strand, so the receiver cannot be detached while received_data runs
+        if (!attached->load(std::memory_order_acquire)) {
+            return;
+        }
+        // The datagram is shared by all receivers and the sender's cache, received_data only reads it
+        mc_app->received_data(const_cast<unsigned char*>(_datagram->data()), _datagram->size(), _remote_endpoint);
+    });
+}
+
+void in_memory_bus::run(std::uint32_t _worker_thread_count) {
+    std::vector<std::thread> worker_threads;
+    for (std::uint32_t i = 1; i < _worker_thread_count; i++) {
+        worker_threads.emplace_back([this]() {
+            try {
+                io_service_.run();
+            }
+            catch (std::exception& e) {
+                std::cerr << "Exception: " << e.what() << "\n";
+            }
+        });
+    }
+    try {
+        io_service_.run();
+    }
+    catch (std::exception& e) {
+        std::cerr << "Exception: " << e.what() << "\n";
+    }
+    for (std::thread& worker_thread : worker_threads) {
+        worker_thread.join();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef IN_MEMORY_BUS
+#define IN_MEMORY_BUS
+
+#include "multicast_application.hpp"
+#include "datagram_channel.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <unordered_map>
+#include <boost/asio.hpp>
+
+#define IN_MEMORY_BUS_FIRST_PORT 1024
+
+// Delivers datagrams between members living in the same process with UDP multicast and unicast semantics:
+// multicast reaches every other member of the group (no loopback), unicast reaches the bound endpoint only.
+class in_memory_bus {
+// Variables
+private:
+    struct member {
+        boost::asio::strand<boost::asio::io_service::executor_type>* strand_;
+        multicast_application* mc_app_;
+        boost::asio::ip::udp::endpoint multicast_endpoint_;
+        // Shared with the datagrams in flight to the member, which check it instead of the member map
+        std::shared_ptr<std::atomic<bool>> attached_;
+    };
+    boost::asio::io_service io_service_;
+    // Exclusive for attach and detach, shared for the sends, which only read the member map
+    std::shared_mutex mutex_;
+    std::unordered_map<boost::asio::ip::udp::endpoint, member> members_;
+    std::uint32_t next_port_;
+// Methods
+public:
+    in_memory_bus();
+    ~in_memory_bus();
+    boost::asio::io_service& get_io_service();
+    boost::asio::ip::udp::endpoint attach(boost::asio::ip::address _listening_interface_by_address, boost::asio::ip::udp::endpoint _multicast_endpoint,
+                                          boost::asio::strand<boost::asio::io_service::executor_type>& _strand, multicast_application& _mc_app);
+    void detach(boost::asio::ip::udp::endpoint _local_endpoint);
+    void send_multicast(boost::asio::ip::udp::endpoint _local_endpoint, boost::asio::ip::udp::endpoint _multicast_endpoint, shared_datagram_t _datagram);
+    void send_to(boost::asio::ip::udp::endpoint _local_endpoint, boost::asio::ip::udp::endpoint _remote_endpoint, shared_datagram_t _datagram);
+    void run(std::uint32_t _worker_thread_count);
+private:
+    void deliver(const member& _member, shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint);
+};
+
+#endif
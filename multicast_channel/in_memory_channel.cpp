@@ -0,0 +1,38 @@
+#include "in_memory_channel.hpp"
+#include "logger.hpp"
+
+in_memory_channel::in_memory_channel(in_memory_bus& _in_memory_bus,
+      boost::asio::strand<boost::asio::io_service::executor_type>& _strand,
+      const boost::asio::ip::address& _listen_interface_by_address,
+      const boost::asio::ip::address& _multicast_address,
+      int _multicast_port, multicast_application& _mc_app)
+    :
+      in_memory_bus_(_in_memory_bus),
+      multicast_endpoint_(_multicast_address, _multicast_port),
+      local_endpoint_(in_memory_bus_.attach(_listen_interface_by_address, multicast_endpoint_, _strand, _mc_app)) {
+}
+
+in_memory_channel::~in_memory_channel() {
+  in_memory_bus_.detach(local_endpoint_);
+}
+
+void in_memory_channel::send_multicast(boost::asio::streambuf& _buffer) {
+  // One copy per datagram, shared by all receivers
+  send_multicast(make_shared_datagram(_buffer));
+}
+
+void in_memory_channel::send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  send_to(make_shared_datagram(_buffer), _remote_endpoint);
+}
+
+void in_memory_channel::send_multicast(shared_datagram_t _datagram) {
+  in_memory_bus_.send_multicast(local_endpoint_, multicast_endpoint_, _datagram);
+}
+
+void in_memory_channel::send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  in_memory_bus_.send_to(local_endpoint_, _remote_endpoint, _datagram);
+}
+
+boost::asio::ip::udp::endpoint in_memory_channel::get_local_endpoint() const {
+  return local_endpoint_;
+}
@@ -0,0 +1,29 @@
+#ifndef IN_MEMORY_CHANNEL
+#define IN_MEMORY_CHANNEL
+
+#include "datagram_channel.hpp"
+#include "in_memory_bus.hpp"
+
+class in_memory_channel : public datagram_channel
+{
+
+private:
+/* Member variables*/
+  in_memory_bus& in_memory_bus_;
+  boost::asio::ip::udp::endpoint multicast_endpoint_;
+  boost::asio::ip::udp::endpoint local_endpoint_;
+
+public:
+  in_memory_channel(in_memory_bus& _in_memory_bus,
+    boost::asio::strand<boost::asio::io_service::executor_type>& _strand,
+    const boost::asio::ip::address& _listen_interface_by_address,
+    const boost::asio::ip::address& _multicast_address,
+    int _multicast_port, multicast_application& _mc_app);
+  ~in_memory_channel();
+  void send_multicast(boost::asio::streambuf& _buffer) override;
+  void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  void send_multicast(shared_datagram_t _datagram) override;
+  void send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  boost::asio::ip::udp::endpoint get_local_endpoint() const override;
+};
+#endif
@@ -1,11 +1,13 @@
 #include "multicast_application_impl.hpp"
 #include "logger.hpp"
 
-multicast_application_impl::multicast_application_impl(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port) : multicast_channel_(std::make_unique<multicast_channel>(io_service_,
-                                            _listening_interface_by_ip,
-                                            _multicast_ip,
-                                            _multicast_port,
-                                            *this)){
+multicast_application_impl::multicast_application_impl(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count, std::uint32_t _send_rate, in_memory_bus* _in_memory_bus) :
+                                            owned_io_service_(_in_memory_bus ? nullptr : std::make_unique<boost::asio::io_service>()),
+                                            io_service_(_in_memory_bus ? _in_memory_bus->get_io_service() : *owned_io_service_),
+                                            strand_(boost::asio::make_strand(io_service_)),
+                                            in_memory_bus_(_in_memory_bus),
+                                            multicast_channel_(create_channel(_listening_interface_by_ip, _multicast_ip, _multicast_port, _send_rate)),
+                                            worker_thread_count_(_worker_thread_count < 1 ? 1 : _worker_thread_count) {
 }
 
 multicast_application_impl::~multicast_application_impl() {
@@ -20,16 +22,78 @@ void multicast_application_impl::send_to(boost::asio::streambuf& _buffer, boost:
   multicast_channel_->send_to(_buffer, _endpoint);
 }
 
+void multicast_application_impl::send_multicast(shared_datagram_t _datagram) {
+  multicast_channel_->send_multicast(_datagram);
+}
+
+void multicast_application_impl::send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _endpoint) {
+  multicast_channel_->send_to(_datagram, _endpoint);
+}
+
+std::shared_ptr<std::vector<unsigned char>> multicast_application_impl::acquire_send_buffer() {
+  return send_buffer_pool_.acquire();
+}
+
+std::unique_ptr<datagram_channel> multicast_application_impl::create_channel(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _send_rate) {
+  // Oversized messages are fragmented below the protocols, so large groups get by with default socket buffers
+  std::unique_ptr<fragmenting_channel> channel = std::make_unique<fragmenting_channel>(*this);
+  if (in_memory_bus_) {
+    channel->set_datagram_channel(std::make_unique<in_memory_channel>(*in_memory_bus_, strand_, _listening_interface_by_ip, _multicast_ip, _multicast_port, *channel));
+  } else {
+    std::unique_ptr<datagram_channel> socket_channel = create_socket_channel(_listening_interface_by_ip, _multicast_ip, _multicast_port, *channel);
+    if (_send_rate > 0) {
+      // Fragments are paced individually, a send rate of 0 disables pacing
+      socket_channel = std::make_unique<pacing_channel>(strand_, std::move(socket_channel), _send_rate);
+    }
+    channel->set_datagram_channel(std::move(socket_channel));
+  }
+  return channel;
+}
+
+std::unique_ptr<datagram_channel> multicast_application_impl::create_socket_channel(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, multicast_application& _mc_app) {
+#ifdef IO_URING
+  // io_uring is preferred when the kernel supports it, otherwise boost::asio over epoll is used
+  try {
+    return std::make_unique<uring_channel>(strand_, _listening_interface_by_ip, _multicast_ip, _multicast_port, _mc_app);
+  } catch (std::runtime_error& _error) {
+    std::cerr << _error.what() << ", falling back to multicast_channel" << std::endl;
+  }
+#endif
+  return std::make_unique<multicast_channel>(strand_, _listening_interface_by_ip, _multicast_ip, _multicast_port, _mc_app);
+}
+
 void multicast_application_impl::start() {
+  if (in_memory_bus_) {
+    // Members on an in-memory bus share its io_service, which is driven by in_memory_bus::run
+    return;
+  }
+  std::vector<std::thread> worker_threads;
+  for (std::uint32_t i = 1; i < worker_thread_count_; i++) {
+    worker_threads.emplace_back([this]() {
+      try {
+        io_service_.run();
+      }
+      catch (std::exception& e) {
+        std::cerr << "Exception: " << e.what() << "\n";
+      }
+    });
+  }
   try {
     io_service_.run();
   }
   catch (std::exception& e) {
     std::cerr << "Exception: " << e.what() << "\n";
   }
+  for (std::thread& worker_thread : worker_threads) {
+    worker_thread.join();
+  }
 }
 
 void multicast_application_impl::stop() {
+  if (in_memory_bus_) {
+    in_memory_bus_->detach(get_local_endpoint());
+    return;
+  }
   io_service_.stop();
 }
 
@@ -37,6 +101,14 @@ boost::asio::io_service& multicast_application_impl::get_io_service() {
   return io_service_;
 }
 
+boost::asio::strand<boost::asio::io_service::executor_type>& multicast_application_impl::get_strand() {
+  return strand_;
+}
+
 boost::asio::ip::udp::endpoint multicast_application_impl::get_local_endpoint() const {
   return multicast_channel_->get_local_endpoint();
+}
+
+transport_statistics multicast_application_impl::get_transport_statistics() const {
+  return multicast_channel_->get_transport_statistics();
 }
\ No newline at end of file
@@ -2,22 +2,43 @@
 #define MULTICAST_APPLICATION_IMPL
 
 #include <memory>
+#include <thread>
+#include <vector>
 #include "multicast_channel.hpp"
+#include "in_memory_channel.hpp"
+#include "fragmenting_channel.hpp"
+#include "uring_channel.hpp"
+#include "pacing_channel.hpp"
+#include "send_buffer_pool.hpp"
 
 class multicast_application_impl : public multicast_application {
     public:
-      multicast_application_impl(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port);
+      multicast_application_impl(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count = 1, std::uint32_t _send_rate = 0, in_memory_bus* _in_memory_bus = nullptr);
       ~multicast_application_impl();
     protected:
       void send_multicast(boost::asio::streambuf& _buffer);
       void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _endpoint);
+      void send_multicast(shared_datagram_t _datagram);
+      void send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _endpoint);
+      // Pooled buffer to serialize an outgoing datagram into, only to be called on the strand
+      std::shared_ptr<std::vector<unsigned char>> acquire_send_buffer();
       void start();
       void stop();
       boost::asio::io_service& get_io_service();
+      boost::asio::strand<boost::asio::io_service::executor_type>& get_strand();
       boost::asio::ip::udp::endpoint get_local_endpoint() const;
+      transport_statistics get_transport_statistics() const;
     private:
-      boost::asio::io_service io_service_; // MUST be listed BEFORE unique_ptr
-      std::unique_ptr<multicast_channel> multicast_channel_;
+      std::unique_ptr<boost::asio::io_service> owned_io_service_; // MUST be listed BEFORE io_service_
+      boost::asio::io_service& io_service_; // MUST be listed BEFORE strand_ and unique_ptr
+      // Serializes socket handlers, timers and protocol state, the remaining workers run offloaded work
+      boost::asio::strand<boost::asio::io_service::executor_type> strand_;
+      in_memory_bus* in_memory_bus_;
+      std::unique_ptr<datagram_channel> multicast_channel_;
+      std::uint32_t worker_thread_count_;
+      send_buffer_pool send_buffer_pool_;
+      std::unique_ptr<datagram_channel> create_channel(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _send_rate);
+      std::unique_ptr<datagram_channel> create_socket_channel(boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, multicast_application& _mc_app);
 };
 
 #endif
\ No newline at end of file
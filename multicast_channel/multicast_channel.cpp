@@ -1,20 +1,33 @@
 #include "multicast_channel.hpp"
 #include "logger.hpp"
 
+#include <cerrno>
+#include <cstring>
+#include <linux/sock_diag.h>
+
 #define UNINITIALIZED_ADDRESS "0.0.0.0"
 #define UNINITIALIZED_PORT 0
 
 using namespace boost::placeholders;
 
-multicast_channel::multicast_channel(boost::asio::io_service& _io_service,
+multicast_channel::multicast_channel(boost::asio::strand<boost::asio::io_service::executor_type>& _strand,
       const boost::asio::ip::address& _listen_interface_by_address,
       const boost::asio::ip::address& _multicast_address,
       int _multicast_port, multicast_application& _mc_app)
     :
       multicast_endpoint_(_multicast_address, _multicast_port),
-      multicast_socket_(_io_service),
-      unicast_socket_(_io_service),
-      mc_app_(_mc_app) {
+      multicast_socket_(_strand),
+      unicast_socket_(_strand),
+      mc_app_(_mc_app),
+      unicast_kernel_drops_(0),
+      multicast_kernel_drops_(0),
+      receive_queue_high_water_mark_(0),
+      send_queue_high_water_mark_(0) {
+#ifdef BATCHED_IO
+    init_batch(unicast_batch_);
+    init_batch(multicast_batch_);
+    send_flush_scheduled_ = false;
+#endif
     try {
       boost::system::error_code ec;
       // Create the multicast socket and bind it to the multicast address and port
@@ -39,38 +52,36 @@ multicast_channel::multicast_channel(boost::asio::io_service& _io_service,
       if (ec) {
         std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
       }
-      multicast_socket_.set_option(boost::asio::ip::udp::socket::receive_buffer_size(max_length), ec);
+      multicast_socket_.set_option(boost::asio::ip::udp::socket::receive_buffer_size(socket_buffer_length), ec);
+      if (ec) {
+        std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
+      }
+      // Datagrams are read synchronously once the socket is readable, never block the io_service on it
+      multicast_socket_.non_blocking(true, ec);
       if (ec) {
         std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
       }
       
-      bool port_not_bound_once = false;
-      do {
-          if(port_not_bound_once) {
-            sleep(1);
-            unicast_socket_.close(ec);
-            if (ec) {
-              std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
-            }
-          }
-          // Create the unicast socket and bind it to an open port
-          unicast_socket_.open(boost::asio::ip::udp::v4(), ec);
-          if (ec) {
-            std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
-          }
-          unicast_socket_.set_option(boost::asio::ip::udp::socket::reuse_address(true), ec);
-          if (ec) {
-            std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
-          }
-          unicast_socket_.bind(boost::asio::ip::udp::endpoint(_listen_interface_by_address, 0), ec);
-          if (ec) {
-            std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
-          }
-          unicast_socket_.set_option(boost::asio::ip::udp::socket::receive_buffer_size(max_length), ec);
-          if (ec) {
-            std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
-          }
-      } while (port_not_bound_once = !is_port_bound_once(get_local_endpoint().port()));
+      // Create the unicast socket and bind it to an open port. SO_REUSEADDR is deliberately not set,
+      // so the kernel hands out an ephemeral port that no other socket holds (exclusive bind)
+      unicast_socket_.open(boost::asio::ip::udp::v4(), ec);
+      if (ec) {
+        std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
+      }
+      unicast_socket_.bind(boost::asio::ip::udp::endpoint(_listen_interface_by_address, 0), ec);
+      if (ec) {
+        std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
+      }
+      unicast_socket_.set_option(boost::asio::ip::udp::socket::receive_buffer_size(socket_buffer_length), ec);
+      if (ec) {
+        std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
+      }
+      unicast_socket_.non_blocking(true, ec);
+      if (ec) {
+        std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
+      }
+      enable_kernel_drop_counter(multicast_socket_);
+      enable_kernel_drop_counter(unicast_socket_);
 
       receive_multicast();
       receive_unicast();
@@ -91,80 +102,271 @@ multicast_channel::~multicast_channel() {
 }
 
 void multicast_channel::send_multicast(boost::asio::streambuf& _buffer) {
+#ifdef BATCHED_IO
+  enqueue_send(make_shared_datagram(_buffer), multicast_endpoint_);
+#else
   unicast_socket_.async_send_to(
       _buffer.data(), multicast_endpoint_,
       boost::bind(&multicast_channel::handle_send_to, this,
         boost::asio::placeholders::error));
+#endif
 }
 
 void multicast_channel::send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) {
+#ifdef BATCHED_IO
+    enqueue_send(make_shared_datagram(_buffer), _remote_endpoint);
+#else
     unicast_socket_.async_send_to(
       _buffer.data(), _remote_endpoint,
       boost::bind(&multicast_channel::handle_send_to, this,
         boost::asio::placeholders::error));
+#endif
+}
+
+void multicast_channel::send_multicast(shared_datagram_t _datagram) {
+  send_to(_datagram, multicast_endpoint_);
+}
+
+void multicast_channel::send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) {
+#ifdef BATCHED_IO
+  enqueue_send(_datagram, _remote_endpoint);
+#else
+  // The handler holds a reference, so the datagram outlives the send without being copied
+  unicast_socket_.async_send_to(
+    boost::asio::buffer(*_datagram), _remote_endpoint,
+    [this, _datagram](const boost::system::error_code& _error, std::size_t) {
+      handle_send_to(_error);
+    });
+#endif
 }
 
 void multicast_channel::handle_send_to(const boost::system::error_code& _error) {
   if (_error) {
     std::cerr << _error.what() << std::endl;
   }
+  sample_queue_lengths(unicast_socket_);
   // ...
 }
 
 void multicast_channel::receive_multicast() {
-  multicast_socket_.async_receive_from(
-  boost::asio::buffer(multicast_data_, max_length), multicast_remote_endpoint_,
+#ifdef BATCHED_IO
+  wait_readable(multicast_socket_, multicast_batch_, multicast_kernel_drops_);
+#else
+  multicast_socket_.async_wait(boost::asio::ip::udp::socket::wait_read,
   boost::bind(&multicast_channel::handle_multicast_receive_from, this,
-        boost::asio::placeholders::error,
-        boost::asio::placeholders::bytes_transferred));
+        boost::asio::placeholders::error));
+#endif
 }
 
 void multicast_channel::receive_unicast() {
-  unicast_socket_.async_receive_from(
-  boost::asio::buffer(unicast_data_, max_length), unicast_remote_endpoint_,
+#ifdef BATCHED_IO
+  wait_readable(unicast_socket_, unicast_batch_, unicast_kernel_drops_);
+#else
+  unicast_socket_.async_wait(boost::asio::ip::udp::socket::wait_read,
   boost::bind(&multicast_channel::handle_unicast_receive_from, this,
-        boost::asio::placeholders::error,
-        boost::asio::placeholders::bytes_transferred));
+        boost::asio::placeholders::error));
+#endif
 }
 
-void multicast_channel::handle_multicast_receive_from(const boost::system::error_code& _error, size_t _bytes_recvd) {
+void multicast_channel::handle_multicast_receive_from(const boost::system::error_code& _error) {
   if (_error) {
     std::cerr << "[<multicast_channel>]: " << _error.what() << std::endl;
+  } else {
+    sample_queue_lengths(multicast_socket_);
+    receive_pooled(multicast_socket_, multicast_remote_endpoint_, multicast_kernel_drops_);
   }
-
-  mc_app_.received_data(multicast_data_, _bytes_recvd, multicast_remote_endpoint_);
   receive_multicast();
 }
 
-void multicast_channel::handle_unicast_receive_from(const boost::system::error_code& _error, size_t _bytes_recvd) {
+void multicast_channel::handle_unicast_receive_from(const boost::system::error_code& _error) {
   if (_error) {
     std::cerr << "[<multicast_channel>]: " << _error.what() << std::endl;
+  } else {
+    sample_queue_lengths(unicast_socket_);
+    receive_pooled(unicast_socket_, unicast_remote_endpoint_, unicast_kernel_drops_);
   }
-
-  mc_app_.received_data(unicast_data_, _bytes_recvd, unicast_remote_endpoint_);
   receive_unicast();
 }
 
+void multicast_channel::receive_pooled(boost::asio::ip::udp::socket& _socket, boost::asio::ip::udp::endpoint& _remote_endpoint, std::uint32_t& _kernel_drops) {
+  boost::system::error_code ec;
+  // For UDP sockets available() reports the size of the next pending datagram
+  size_t datagram_length = _socket.available(ec);
+  if (ec) {
+    std::cerr << "[<multicast_channel>]: " << ec.what() << std::endl;
+    return;
+  }
+  size_t buffer_length = datagram_length > receive_buffer_pool::slab_length ? datagram_length : static_cast<size_t>(receive_buffer_pool::slab_length);
+  std::unique_ptr<unsigned char[]> buffer = buffer_length == receive_buffer_pool::slab_length ? receive_buffer_pool_.acquire() : receive_buffer_pool_.acquire_oversized(buffer_length);
+  // recvmsg instead of receive_from, so the drop counter is delivered alongside the datagram
+  iovec buffer_iovec{buffer.get(), buffer_length};
+  alignas(cmsghdr) unsigned char control[kernel_drops_control_length];
+  msghdr header{};
+  header.msg_name = _remote_endpoint.data();
+  header.msg_namelen = _remote_endpoint.capacity();
+  header.msg_iov = &buffer_iovec;
+  header.msg_iovlen = 1;
+  header.msg_control = control;
+  header.msg_controllen = sizeof(control);
+  ssize_t bytes_recvd = recvmsg(_socket.native_handle(), &header, MSG_DONTWAIT);
+  if (bytes_recvd < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      std::cerr << "[<multicast_channel>]: (recvmsg) " << std::strerror(errno) << std::endl;
+    }
+  } else {
+    _remote_endpoint.resize(header.msg_namelen);
+    record_kernel_drops(header, _kernel_drops);
+    mc_app_.received_data(buffer.get(), bytes_recvd, _remote_endpoint);
+  }
+  receive_buffer_pool_.release(std::move(buffer), buffer_length);
+}
+
 boost::asio::ip::udp::endpoint multicast_channel::get_local_endpoint() const {
   return unicast_socket_.local_endpoint();
 }
 
-bool multicast_channel::is_port_bound_once(std::uint16_t _port) {
-  std::stringstream command; command << "echo -n $(ss -lu | awk '{print $4}' |  awk -F: '{print $NF}' | grep " << _port << " | wc -l)";
-  const std::size_t buffer_size = 4UL;
-  std::array<char, buffer_size> buffer;
-  std::string result;
-  // Open a pipe and execute the command
-  FILE* pipe = popen(command.str().c_str(), "r");
-  if (!pipe) {
-      std::cerr << "Failed to run command." << std::endl;
-      return 0;
-  }
-  // Read and capture the output
-  while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-      result += buffer.data();
-  }
-  // Close the pipe
-  pclose(pipe);
-  return std::stoi(result) == 1;
-}
\ No newline at end of file
+transport_statistics multicast_channel::get_transport_statistics() const {
+  transport_statistics statistics;
+  statistics.kernel_drops_ = std::uint64_t(unicast_kernel_drops_) + multicast_kernel_drops_;
+  statistics.receive_queue_high_water_mark_ = receive_queue_high_water_mark_;
+  statistics.send_queue_high_water_mark_ = send_queue_high_water_mark_;
+  return statistics;
+}
+
+void multicast_channel::enable_kernel_drop_counter(boost::asio::ip::udp::socket& _socket) {
+  int enable = 1;
+  if (setsockopt(_socket.native_handle(), SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) < 0) {
+    std::cerr << "[<multicast_channel>]: (SO_RXQ_OVFL) " << std::strerror(errno) << std::endl;
+  }
+}
+
+void multicast_channel::record_kernel_drops(msghdr& _header, std::uint32_t& _kernel_drops) {
+  for (cmsghdr* control = CMSG_FIRSTHDR(&_header); control; control = CMSG_NXTHDR(&_header, control)) {
+    if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL) {
+      std::memcpy(&_kernel_drops, CMSG_DATA(control), sizeof(std::uint32_t));
+    }
+  }
+}
+
+void multicast_channel::sample_queue_lengths(boost::asio::ip::udp::socket& _socket) {
+  // Bytes currently held by the socket's receive and send queues
+  std::uint32_t meminfo[SK_MEMINFO_VARS];
+  socklen_t meminfo_length = sizeof(meminfo);
+  if (getsockopt(_socket.native_handle(), SOL_SOCKET, SO_MEMINFO, meminfo, &meminfo_length) < 0) {
+    return;
+  }
+  receive_queue_high_water_mark_ = std::max<std::uint64_t>(receive_queue_high_water_mark_, meminfo[SK_MEMINFO_RMEM_ALLOC]);
+  send_queue_high_water_mark_ = std::max<std::uint64_t>(send_queue_high_water_mark_, meminfo[SK_MEMINFO_WMEM_ALLOC]);
+}
+
+#ifdef BATCHED_IO
+void multicast_channel::init_batch(datagram_batch& _batch) {
+  for (size_t i = 0; i < receive_batch_size; i++) {
+    _batch.slabs_[i] = receive_buffer_pool_.acquire();
+    // Default-initialized, so the pages stay unbacked until an oversized datagram actually lands there
+    _batch.overflows_[i] = std::unique_ptr<unsigned char[]>(new unsigned char[max_datagram_length - static_cast<size_t>(receive_buffer_pool::slab_length)]);
+    _batch.iovecs_[i][0].iov_base = _batch.slabs_[i].get();
+    _batch.iovecs_[i][0].iov_len = receive_buffer_pool::slab_length;
+    _batch.iovecs_[i][1].iov_base = _batch.overflows_[i].get();
+    _batch.iovecs_[i][1].iov_len = max_datagram_length - static_cast<size_t>(receive_buffer_pool::slab_length);
+  }
+}
+
+void multicast_channel::wait_readable(boost::asio::ip::udp::socket& _socket, datagram_batch& _batch, std::uint32_t& _kernel_drops) {
+  _socket.async_wait(boost::asio::ip::udp::socket::wait_read,
+  boost::bind(&multicast_channel::handle_readable, this,
+        boost::asio::placeholders::error, boost::ref(_socket), boost::ref(_batch), boost::ref(_kernel_drops)));
+}
+
+void multicast_channel::handle_readable(const boost::system::error_code& _error, boost::asio::ip::udp::socket& _socket, datagram_batch& _batch, std::uint32_t& _kernel_drops) {
+  if (_error) {
+    std::cerr << "[<multicast_channel>]: " << _error.what() << std::endl;
+    if (_error == boost::asio::error::operation_aborted) {
+      return;
+    }
+  }
+  // Drain up to receive_batch_size datagrams with a single syscall, each slot keeps its own sender endpoint
+  for (size_t i = 0; i < receive_batch_size; i++) {
+    std::memset(&_batch.headers_[i], 0, sizeof(mmsghdr));
+    _batch.headers_[i].msg_hdr.msg_iov = _batch.iovecs_[i].data();
+    _batch.headers_[i].msg_hdr.msg_iovlen = _batch.iovecs_[i].size();
+    _batch.headers_[i].msg_hdr.msg_name = _batch.remote_endpoints_[i].data();
+    _batch.headers_[i].msg_hdr.msg_namelen = _batch.remote_endpoints_[i].capacity();
+    _batch.headers_[i].msg_hdr.msg_control = _batch.controls_[i].data();
+    _batch.headers_[i].msg_hdr.msg_controllen = _batch.controls_[i].size();
+  }
+  sample_queue_lengths(_socket);
+  int datagrams_recvd = recvmmsg(_socket.native_handle(), _batch.headers_.data(), receive_batch_size, MSG_DONTWAIT, nullptr);
+  if (datagrams_recvd < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+    std::cerr << "[<multicast_channel>]: (recvmmsg) " << std::strerror(errno) << std::endl;
+  }
+  for (int i = 0; i < datagrams_recvd; i++) {
+    _batch.remote_endpoints_[i].resize(_batch.headers_[i].msg_hdr.msg_namelen);
+    record_kernel_drops(_batch.headers_[i].msg_hdr, _kernel_drops);
+    size_t bytes_recvd = _batch.headers_[i].msg_len;
+    if (bytes_recvd <= receive_buffer_pool::slab_length) {
+      mc_app_.received_data(_batch.slabs_[i].get(), bytes_recvd, _batch.remote_endpoints_[i]);
+    } else {
+      // Reassemble the scattered datagram into one contiguous oversized buffer
+      std::unique_ptr<unsigned char[]> oversized = receive_buffer_pool_.acquire_oversized(bytes_recvd);
+      std::memcpy(oversized.get(), _batch.slabs_[i].get(), receive_buffer_pool::slab_length);
+      std::memcpy(oversized.get() + receive_buffer_pool::slab_length, _batch.overflows_[i].get(), bytes_recvd - receive_buffer_pool::slab_length);
+      mc_app_.received_data(oversized.get(), bytes_recvd, _batch.remote_endpoints_[i]);
+    }
+  }
+  wait_readable(_socket, _batch, _kernel_drops);
+}
+
+void multicast_channel::enqueue_send(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  send_queue_.push_back({_datagram, _remote_endpoint});
+  if (!send_flush_scheduled_) {
+    send_flush_scheduled_ = true;
+    boost::asio::post(unicast_socket_.get_executor(), boost::bind(&multicast_channel::flush_send_queue, this));
+  }
+}
+
+void multicast_channel::flush_send_queue() {
+  send_flush_scheduled_ = false;
+  send_headers_.resize(send_queue_.size());
+  send_iovecs_.resize(send_queue_.size());
+  std::vector<mmsghdr>& headers = send_headers_;
+  std::vector<iovec>& iovecs = send_iovecs_;
+  for (size_t i = 0; i < send_queue_.size(); i++) {
+    // sendmmsg only reads from the iovec, the shared datagram is never modified
+    iovecs[i].iov_base = const_cast<unsigned char*>(send_queue_[i].data_->data());
+    iovecs[i].iov_len = send_queue_[i].data_->size();
+    std::memset(&headers[i], 0, sizeof(mmsghdr));
+    headers[i].msg_hdr.msg_iov = &iovecs[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+    headers[i].msg_hdr.msg_name = send_queue_[i].remote_endpoint_.data();
+    headers[i].msg_hdr.msg_namelen = send_queue_[i].remote_endpoint_.size();
+  }
+  size_t datagrams_sent = 0;
+  while (datagrams_sent < headers.size()) {
+    int sent = sendmmsg(unicast_socket_.native_handle(), headers.data() + datagrams_sent, headers.size() - datagrams_sent, MSG_DONTWAIT);
+    if (sent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      // Skip the datagram which caused the error, as async_send_to would have reported and dropped it
+      std::cerr << "[<multicast_channel>]: (sendmmsg) " << std::strerror(errno) << std::endl;
+      sent = 1;
+    }
+    datagrams_sent += sent;
+  }
+  send_queue_.erase(send_queue_.begin(), send_queue_.begin() + datagrams_sent);
+  sample_queue_lengths(unicast_socket_);
+  if (!send_queue_.empty() && !send_flush_scheduled_) {
+    // Send buffer is full, retry once the socket becomes writable again
+    send_flush_scheduled_ = true;
+    unicast_socket_.async_wait(boost::asio::ip::udp::socket::wait_write, [this](const boost::system::error_code& _error) {
+      if (_error) {
+        std::cerr << "[<multicast_channel>]: " << _error.what() << std::endl;
+        send_flush_scheduled_ = false;
+        return;
+      }
+      flush_send_queue();
+    });
+  }
+}
+#endif
\ No newline at end of file
@@ -2,13 +2,20 @@
 #define MULTICAST_CHANNEL
 
 #include "multicast_application.hpp"
+#include "datagram_channel.hpp"
+#include "receive_buffer_pool.hpp"
 
 #include <string>
 #include <sstream>
 #include <boost/asio.hpp>
 #include <boost/bind/bind.hpp>
+#include <sys/socket.h>
+#ifdef BATCHED_IO
+#include <array>
+#include <vector>
+#endif
 
-class multicast_channel
+class multicast_channel : public datagram_channel
 {
 
 private:
@@ -19,27 +26,69 @@ private:
   boost::asio::ip::udp::endpoint unicast_remote_endpoint_;
   boost::asio::ip::udp::endpoint multicast_remote_endpoint_;
   std::string message_;
-  enum { max_length = 8388608 };
-  unsigned char unicast_data_[max_length];
-  unsigned char multicast_data_[max_length];
+  enum { socket_buffer_length = 8388608, max_datagram_length = 65507 };
+  receive_buffer_pool receive_buffer_pool_;
   multicast_application& mc_app_;
+  // SO_RXQ_OVFL reports the cumulative number of datagrams the kernel dropped on a socket
+  enum { kernel_drops_control_length = CMSG_SPACE(sizeof(std::uint32_t)) };
+  std::uint32_t unicast_kernel_drops_;
+  std::uint32_t multicast_kernel_drops_;
+  std::uint64_t receive_queue_high_water_mark_;
+  std::uint64_t send_queue_high_water_mark_;
+#ifdef BATCHED_IO
+  enum { receive_batch_size = 16 };
+  struct datagram_batch {
+    std::array<mmsghdr, receive_batch_size> headers_;
+    // Each slot scatters into a pooled slab first, the overflow area is only touched by oversized datagrams
+    std::array<std::array<iovec, 2>, receive_batch_size> iovecs_;
+    std::array<boost::asio::ip::udp::endpoint, receive_batch_size> remote_endpoints_;
+    // CMSG_SPACE is a multiple of the header alignment, so aligning the first slot aligns all of them
+    alignas(cmsghdr) std::array<std::array<unsigned char, kernel_drops_control_length>, receive_batch_size> controls_;
+    std::array<std::unique_ptr<unsigned char[]>, receive_batch_size> slabs_;
+    std::array<std::unique_ptr<unsigned char[]>, receive_batch_size> overflows_;
+  };
+  struct pending_datagram {
+    shared_datagram_t data_;
+    boost::asio::ip::udp::endpoint remote_endpoint_;
+  };
+  datagram_batch unicast_batch_;
+  datagram_batch multicast_batch_;
+  std::vector<pending_datagram> send_queue_;
+  // Reused by every flush, they keep the capacity of the largest batch
+  std::vector<mmsghdr> send_headers_;
+  std::vector<iovec> send_iovecs_;
+  bool send_flush_scheduled_;
+#endif
 private:
 /* Methods */
   void handle_send_to(const boost::system::error_code& _error);
   void receive_multicast();
   void receive_unicast();
-  void handle_multicast_receive_from(const boost::system::error_code& _error, size_t _bytes_recvd);
-  void handle_unicast_receive_from(const boost::system::error_code& _error, size_t _bytes_recvd);
-  bool is_port_bound_once(std::uint16_t _port);
+  void handle_multicast_receive_from(const boost::system::error_code& _error);
+  void handle_unicast_receive_from(const boost::system::error_code& _error);
+  void receive_pooled(boost::asio::ip::udp::socket& _socket, boost::asio::ip::udp::endpoint& _remote_endpoint, std::uint32_t& _kernel_drops);
+  void enable_kernel_drop_counter(boost::asio::ip::udp::socket& _socket);
+  void record_kernel_drops(msghdr& _header, std::uint32_t& _kernel_drops);
+  void sample_queue_lengths(boost::asio::ip::udp::socket& _socket);
+#ifdef BATCHED_IO
+  void init_batch(datagram_batch& _batch);
+  void wait_readable(boost::asio::ip::udp::socket& _socket, datagram_batch& _batch, std::uint32_t& _kernel_drops);
+  void handle_readable(const boost::system::error_code& _error, boost::asio::ip::udp::socket& _socket, datagram_batch& _batch, std::uint32_t& _kernel_drops);
+  void enqueue_send(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint);
+  void flush_send_queue();
+#endif
 
 public:
-  multicast_channel(boost::asio::io_service& _io_service,
+  multicast_channel(boost::asio::strand<boost::asio::io_service::executor_type>& _strand,
     const boost::asio::ip::address& _listen_interface_by_address,
     const boost::asio::ip::address& _multicast_address,
     int _multicast_port, multicast_application& _mc_app);
   ~multicast_channel();
-  void send_multicast(boost::asio::streambuf& _buffer);
-  void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint);
-  boost::asio::ip::udp::endpoint get_local_endpoint() const;
+  void send_multicast(boost::asio::streambuf& _buffer) override;
+  void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  void send_multicast(shared_datagram_t _datagram) override;
+  void send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  boost::asio::ip::udp::endpoint get_local_endpoint() const override;
+  transport_statistics get_transport_statistics() const override;
 };
 #endif
\ No newline at end of file
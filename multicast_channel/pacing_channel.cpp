@@ -0,0 +1,108 @@
+#include "pacing_channel.hpp"
+#include "logger.hpp"
+
+pacing_channel::pacing_channel(boost::asio::strand<boost::asio::io_service::executor_type>& _strand, std::unique_ptr<datagram_channel> _datagram_channel, std::uint32_t _send_rate)
+    :
+      datagram_channel_(std::move(_datagram_channel)),
+      send_rate_(_send_rate),
+      tokens_(bucket_length),
+      last_refill_(std::chrono::steady_clock::now()),
+      pacing_timer_(_strand),
+      pacing_scheduled_(false) {
+}
+
+pacing_channel::~pacing_channel() {
+}
+
+void pacing_channel::send_multicast(boost::asio::streambuf& _buffer) {
+  if (send_queue_.empty() && try_consume(_buffer.size())) {
+    datagram_channel_->send_multicast(_buffer);
+    return;
+  }
+  enqueue(make_shared_datagram(_buffer), std::nullopt);
+}
+
+void pacing_channel::send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  if (send_queue_.empty() && try_consume(_buffer.size())) {
+    datagram_channel_->send_to(_buffer, _remote_endpoint);
+    return;
+  }
+  enqueue(make_shared_datagram(_buffer), _remote_endpoint);
+}
+
+void pacing_channel::send_multicast(shared_datagram_t _datagram) {
+  if (send_queue_.empty() && try_consume(_datagram->size())) {
+    datagram_channel_->send_multicast(_datagram);
+    return;
+  }
+  enqueue(_datagram, std::nullopt);
+}
+
+void pacing_channel::send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  if (send_queue_.empty() && try_consume(_datagram->size())) {
+    datagram_channel_->send_to(_datagram, _remote_endpoint);
+    return;
+  }
+  enqueue(_datagram, _remote_endpoint);
+}
+
+boost::asio::ip::udp::endpoint pacing_channel::get_local_endpoint() const {
+  return datagram_channel_->get_local_endpoint();
+}
+
+transport_statistics pacing_channel::get_transport_statistics() const {
+  return datagram_channel_->get_transport_statistics();
+}
+
+void pacing_channel::refill() {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  tokens_ = std::min<double>(bucket_length, tokens_ + std::chrono::duration<double>(now - last_refill_).count() * send_rate_);
+  last_refill_ = now;
+}
+
+bool pacing_channel::try_consume(size_t _length) {
+  refill();
+  if (tokens_ < _length) {
+    return false;
+  }
+  tokens_ -= _length;
+  return true;
+}
+
+void pacing_channel::enqueue(shared_datagram_t _datagram, std::optional<boost::asio::ip::udp::endpoint> _remote_endpoint) {
+  send_queue_.push_back({_datagram, _remote_endpoint});
+  schedule_pacing();
+}
+
+void pacing_channel::schedule_pacing() {
+  if (pacing_scheduled_ || send_queue_.empty()) {
+    return;
+  }
+  pacing_scheduled_ = true;
+  // Wake up once enough tokens accumulated for the head of the queue
+  double missing_tokens = std::max(0.0, send_queue_.front().data_->size() - tokens_);
+  pacing_timer_.expires_from_now(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(missing_tokens / send_rate_)));
+  pacing_timer_.async_wait([this](const boost::system::error_code& _error) {
+    handle_pacing(_error);
+  });
+}
+
+void pacing_channel::handle_pacing(const boost::system::error_code& _error) {
+  pacing_scheduled_ = false;
+  if (_error) {
+    if (_error != boost::asio::error::operation_aborted) {
+      std::cerr << "[<pacing_channel>]: " << _error.what() << std::endl;
+    }
+    return;
+  }
+  while (!send_queue_.empty() && try_consume(send_queue_.front().data_->size())) {
+    pending_datagram& datagram = send_queue_.front();
+    if (datagram.remote_endpoint_) {
+      datagram_channel_->send_to(datagram.data_, datagram.remote_endpoint_.value());
+    } else {
+      datagram_channel_->send_multicast(datagram.data_);
+    }
+    send_queue_.pop_front();
+  }
+  schedule_pacing();
+}
@@ -0,0 +1,54 @@
+#ifndef PACING_CHANNEL
+#define PACING_CHANNEL
+
+#include "datagram_channel.hpp"
+
+#include <deque>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <boost/asio.hpp>
+
+// Token bucket in front of a socket channel. Datagrams are sent right away while tokens (bytes) are left,
+// bursts beyond the bucket are queued and released by a timer at the configured rate, so receivers with
+// default socket buffers are not overrun by a sponsor's response bursts.
+class pacing_channel : public datagram_channel
+{
+
+private:
+/* Member variables*/
+  // Holds one maximum sized datagram, so every datagram eventually fits into the bucket
+  enum { bucket_length = 65536 };
+  struct pending_datagram {
+    shared_datagram_t data_;
+    // Empty for multicast datagrams
+    std::optional<boost::asio::ip::udp::endpoint> remote_endpoint_;
+  };
+  std::unique_ptr<datagram_channel> datagram_channel_;
+  double send_rate_;
+  double tokens_;
+  std::chrono::steady_clock::time_point last_refill_;
+  std::deque<pending_datagram> send_queue_;
+  boost::asio::steady_timer pacing_timer_;
+  bool pacing_scheduled_;
+
+private:
+/* Methods */
+  void refill();
+  bool try_consume(size_t _length);
+  void enqueue(shared_datagram_t _datagram, std::optional<boost::asio::ip::udp::endpoint> _remote_endpoint);
+  void schedule_pacing();
+  void handle_pacing(const boost::system::error_code& _error);
+
+public:
+  // _send_rate in bytes per second
+  pacing_channel(boost::asio::strand<boost::asio::io_service::executor_type>& _strand, std::unique_ptr<datagram_channel> _datagram_channel, std::uint32_t _send_rate);
+  ~pacing_channel();
+  void send_multicast(boost::asio::streambuf& _buffer) override;
+  void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  void send_multicast(shared_datagram_t _datagram) override;
+  void send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  boost::asio::ip::udp::endpoint get_local_endpoint() const override;
+  transport_statistics get_transport_statistics() const override;
+};
+#endif
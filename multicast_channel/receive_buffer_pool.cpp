@@ -0,0 +1,27 @@
+#include "receive_buffer_pool.hpp"
+
+receive_buffer_pool::receive_buffer_pool() {
+}
+
+receive_buffer_pool::~receive_buffer_pool() {
+}
+
+std::unique_ptr<unsigned char[]> receive_buffer_pool::acquire() {
+    if (free_slabs_.empty()) {
+        return std::unique_ptr<unsigned char[]>(new unsigned char[slab_length]);
+    }
+    std::unique_ptr<unsigned char[]> slab = std::move(free_slabs_.back());
+    free_slabs_.pop_back();
+    return slab;
+}
+
+std::unique_ptr<unsigned char[]> receive_buffer_pool::acquire_oversized(size_t _length) {
+    // Rare path: exactly sized and never pooled, so a single large datagram does not pin memory
+    return std::unique_ptr<unsigned char[]>(new unsigned char[_length]);
+}
+
+void receive_buffer_pool::release(std::unique_ptr<unsigned char[]> _slab, size_t _length) {
+    if (_length == slab_length) {
+        free_slabs_.push_back(std::move(_slab));
+    }
+}
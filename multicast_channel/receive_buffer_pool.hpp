@@ -0,0 +1,24 @@
+#ifndef RECEIVE_BUFFER_POOL
+#define RECEIVE_BUFFER_POOL
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+class receive_buffer_pool {
+// Variables
+public:
+    // Large enough for every regular protocol message, datagrams above are served by acquire_oversized
+    enum { slab_length = 2048 };
+private:
+    std::vector<std::unique_ptr<unsigned char[]>> free_slabs_;
+// Methods
+public:
+    receive_buffer_pool();
+    ~receive_buffer_pool();
+    std::unique_ptr<unsigned char[]> acquire();
+    std::unique_ptr<unsigned char[]> acquire_oversized(size_t _length);
+    void release(std::unique_ptr<unsigned char[]> _slab, size_t _length);
+};
+
+#endif
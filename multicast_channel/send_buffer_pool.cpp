@@ -0,0 +1,30 @@
+#include "send_buffer_pool.hpp"
+
+#include <atomic>
+
+send_buffer_pool::send_buffer_pool() : next_buffer_(0) {
+}
+
+send_buffer_pool::~send_buffer_pool() {
+}
+
+std::shared_ptr<std::vector<unsigned char>> send_buffer_pool::acquire() {
+    // Round-robin, the buffer after the last acquired one is the most likely to be sent already
+    for (size_t i = 0; i < buffers_.size(); i++) {
+        size_t index = (next_buffer_ + i) % buffers_.size();
+        if (buffers_[index].use_count() == 1) {
+            // The last send may have released the buffer on another thread, order its reads before our writes
+            std::atomic_thread_fence(std::memory_order_acquire);
+            next_buffer_ = index + 1;
+            buffers_[index]->clear();
+            return buffers_[index];
+        }
+    }
+    std::shared_ptr<std::vector<unsigned char>> buffer = std::make_shared<std::vector<unsigned char>>();
+    buffer->reserve(initial_capacity);
+    if (buffers_.size() < max_buffers) {
+        buffers_.push_back(buffer);
+        next_buffer_ = 0;
+    }
+    return buffer;
+}
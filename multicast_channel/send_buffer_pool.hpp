@@ -0,0 +1,30 @@
+#ifndef SEND_BUFFER_POOL
+#define SEND_BUFFER_POOL
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+// Recycles the storage of outgoing datagrams. A buffer is free again once every send holding it completed,
+// i.e. the pool holds its last reference, and keeps its capacity, so steady-state sending does not allocate.
+// Not thread-safe, buffers have to be acquired from a single thread (the member's strand).
+// Buffers must not be retained after their sends, datagrams cached for retransmissions are allocated separately,
+// otherwise acquire() scans past them on every call. The pool is capped at max_buffers, beyond that acquire()
+// returns plain buffers that are not recycled, so the scan stays bounded however many datagrams are in flight.
+class send_buffer_pool {
+// Variables
+public:
+    // Capacity reserved for new buffers, enough for every regular protocol message
+    enum { initial_capacity = 2048, max_buffers = 64 };
+private:
+    std::vector<std::shared_ptr<std::vector<unsigned char>>> buffers_;
+    size_t next_buffer_;
+// Methods
+public:
+    send_buffer_pool();
+    ~send_buffer_pool();
+    // Returns an empty buffer, it is handed out again after the last copy of the returned pointer is gone
+    std::shared_ptr<std::vector<unsigned char>> acquire();
+};
+
+#endif
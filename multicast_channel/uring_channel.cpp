@@ -0,0 +1,340 @@
+#ifdef IO_URING
+#include "uring_channel.hpp"
+#include "logger.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <linux/sock_diag.h>
+
+uring_channel::uring_channel(boost::asio::strand<boost::asio::io_service::executor_type>& _strand,
+      const boost::asio::ip::address& _listen_interface_by_address,
+      const boost::asio::ip::address& _multicast_address,
+      int _multicast_port, multicast_application& _mc_app)
+    :
+      ring_initialized_(false),
+      unicast_socket_(_strand),
+      multicast_socket_(_strand),
+      multicast_endpoint_(_multicast_address, _multicast_port),
+      completion_event_(_strand),
+      completion_event_count_(0),
+      unicast_buffers_{nullptr, nullptr, UNICAST_RECEIVE},
+      multicast_buffers_{nullptr, nullptr, MULTICAST_RECEIVE},
+      unicast_kernel_drops_(0),
+      multicast_kernel_drops_(0),
+      receive_queue_high_water_mark_(0),
+      send_queue_high_water_mark_(0),
+      next_send_id_(MULTICAST_RECEIVE + 1),
+      submit_scheduled_(false),
+      mc_app_(_mc_app) {
+    // Probe the kernel before any socket is bound, a failure leaves nothing behind for the fallback channel
+    setup_ring();
+
+    boost::system::error_code ec;
+    // Create the multicast socket and bind it to the multicast address and port
+    multicast_socket_.open(boost::asio::ip::udp::v4(), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+    multicast_socket_.set_option(boost::asio::ip::udp::socket::reuse_address(true), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+    multicast_socket_.bind(boost::asio::ip::udp::endpoint(_multicast_address, _multicast_port), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+    // Join the multicast group.
+    multicast_socket_.set_option(boost::asio::ip::multicast::join_group(_multicast_address.to_v4(), _listen_interface_by_address.to_v4()), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+    multicast_socket_.set_option(boost::asio::ip::multicast::enable_loopback(false), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+    multicast_socket_.set_option(boost::asio::ip::udp::socket::receive_buffer_size(socket_buffer_length), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+
+    // Create the unicast socket and bind it exclusively to an ephemeral port
+    unicast_socket_.open(boost::asio::ip::udp::v4(), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+    unicast_socket_.bind(boost::asio::ip::udp::endpoint(_listen_interface_by_address, 0), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+    unicast_socket_.set_option(boost::asio::ip::udp::socket::receive_buffer_size(socket_buffer_length), ec);
+    if (ec) {
+      std::cerr << "[<uring_channel>]: " << ec.what() << std::endl;
+    }
+
+    int enable = 1;
+    for (boost::asio::ip::udp::socket* socket : {&unicast_socket_, &multicast_socket_}) {
+      if (setsockopt(socket->native_handle(), SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) < 0) {
+        std::cerr << "[<uring_channel>]: (SO_RXQ_OVFL) " << std::strerror(errno) << std::endl;
+      }
+    }
+
+    // Multishot recvmsg reports the source address and control messages in each buffer, only their lengths are taken from this header
+    std::memset(&receive_msghdr_, 0, sizeof(msghdr));
+    receive_msghdr_.msg_namelen = sizeof(sockaddr_in);
+    receive_msghdr_.msg_controllen = CMSG_SPACE(sizeof(std::uint32_t));
+    arm_receive(UNICAST_RECEIVE);
+    arm_receive(MULTICAST_RECEIVE);
+    schedule_submit();
+    wait_completions();
+}
+
+uring_channel::~uring_channel() {
+  try {
+    unicast_socket_.close();
+    multicast_socket_.close();
+  } catch (boost::system::system_error _error) {
+    std::cerr << "[<uring_channel>]: (~uring_channel) " << _error.what() << std::endl;
+  }
+  release_ring();
+}
+
+void uring_channel::setup_ring() {
+  int result = io_uring_queue_init(ring_entries, &ring_, 0);
+  if (result < 0) {
+    throw std::runtime_error(std::string("[<uring_channel>]: (setup_ring) io_uring_queue_init failed: ") + std::strerror(-result));
+  }
+  ring_initialized_ = true;
+  // Multishot recvmsg arrived in Linux 6.0 together with IORING_OP_SEND_ZC, which is probed as its marker
+  io_uring_probe* probe = io_uring_get_probe_ring(&ring_);
+  bool supported = probe && io_uring_opcode_supported(probe, IORING_OP_RECVMSG) && io_uring_opcode_supported(probe, IORING_OP_SENDMSG)
+                         && io_uring_opcode_supported(probe, IORING_OP_SEND_ZC);
+  if (probe) {
+    io_uring_free_probe(probe);
+  }
+  if (!supported) {
+    release_ring();
+    throw std::runtime_error("[<uring_channel>]: (setup_ring) kernel lacks multishot recvmsg");
+  }
+  try {
+    setup_buffer_ring(unicast_buffers_, UNICAST_RECEIVE);
+    setup_buffer_ring(multicast_buffers_, MULTICAST_RECEIVE);
+  } catch (std::runtime_error& _error) {
+    release_ring();
+    throw;
+  }
+  int event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd < 0 || io_uring_register_eventfd(&ring_, event_fd) < 0) {
+    if (event_fd >= 0) {
+      close(event_fd);
+    }
+    release_ring();
+    throw std::runtime_error("[<uring_channel>]: (setup_ring) registering the completion eventfd failed");
+  }
+  completion_event_.assign(event_fd);
+}
+
+void uring_channel::setup_buffer_ring(buffer_ring& _buffer_ring, std::uint16_t _group_id) {
+  int result = 0;
+  _buffer_ring.ring_ = io_uring_setup_buf_ring(&ring_, receive_buffer_count, _group_id, 0, &result);
+  if (!_buffer_ring.ring_) {
+    throw std::runtime_error(std::string("[<uring_channel>]: (setup_buffer_ring) io_uring_setup_buf_ring failed: ") + std::strerror(-result));
+  }
+  _buffer_ring.buffers_ = std::unique_ptr<unsigned char[]>(new unsigned char[receive_buffer_count * receive_buffer_length]);
+  _buffer_ring.group_id_ = _group_id;
+  for (std::uint16_t buffer_id = 0; buffer_id < receive_buffer_count; buffer_id++) {
+    io_uring_buf_ring_add(_buffer_ring.ring_, _buffer_ring.buffers_.get() + buffer_id * receive_buffer_length, receive_buffer_length,
+                          buffer_id, io_uring_buf_ring_mask(receive_buffer_count), buffer_id);
+  }
+  io_uring_buf_ring_advance(_buffer_ring.ring_, receive_buffer_count);
+}
+
+void uring_channel::release_ring() {
+  if (!ring_initialized_) {
+    return;
+  }
+  for (buffer_ring* buffers : {&unicast_buffers_, &multicast_buffers_}) {
+    if (buffers->ring_) {
+      io_uring_free_buf_ring(&ring_, buffers->ring_, receive_buffer_count, buffers->group_id_);
+      buffers->ring_ = nullptr;
+    }
+  }
+  // Cancels the multishot receives and any send still in flight
+  io_uring_queue_exit(&ring_);
+  ring_initialized_ = false;
+}
+
+io_uring_sqe* uring_channel::get_sqe() {
+  io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (!sqe) {
+    // Submission queue is full, flush it early instead of waiting for the scheduled submit
+    io_uring_submit(&ring_);
+    sqe = io_uring_get_sqe(&ring_);
+  }
+  return sqe;
+}
+
+void uring_channel::arm_receive(receive_tag _tag) {
+  io_uring_sqe* sqe = get_sqe();
+  if (!sqe) {
+    std::cerr << "[<uring_channel>]: (arm_receive) submission queue exhausted" << std::endl;
+    return;
+  }
+  buffer_ring& buffers = _tag == UNICAST_RECEIVE ? unicast_buffers_ : multicast_buffers_;
+  int socket_fd = _tag == UNICAST_RECEIVE ? unicast_socket_.native_handle() : multicast_socket_.native_handle();
+  io_uring_prep_recvmsg_multishot(sqe, socket_fd, &receive_msghdr_, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = buffers.group_id_;
+  io_uring_sqe_set_data64(sqe, _tag);
+}
+
+void uring_channel::schedule_submit() {
+  if (submit_scheduled_) {
+    return;
+  }
+  submit_scheduled_ = true;
+  // All operations queued during this strand turn are handed to the kernel with one syscall
+  boost::asio::post(completion_event_.get_executor(), [this]() {
+    submit_scheduled_ = false;
+    int result = io_uring_submit(&ring_);
+    if (result < 0) {
+      std::cerr << "[<uring_channel>]: (io_uring_submit) " << std::strerror(-result) << std::endl;
+    }
+  });
+}
+
+void uring_channel::wait_completions() {
+  completion_event_.async_wait(boost::asio::posix::stream_descriptor::wait_read,
+    [this](const boost::system::error_code& _error) {
+      handle_completions(_error);
+    });
+}
+
+void uring_channel::handle_completions(const boost::system::error_code& _error) {
+  if (_error) {
+    if (_error != boost::asio::error::operation_aborted) {
+      std::cerr << "[<uring_channel>]: " << _error.what() << std::endl;
+    }
+    return;
+  }
+  boost::system::error_code ec;
+  completion_event_.read_some(boost::asio::buffer(&completion_event_count_, sizeof(completion_event_count_)), ec);
+  sample_queue_lengths(unicast_socket_);
+  sample_queue_lengths(multicast_socket_);
+  io_uring_cqe* cqe;
+  while (io_uring_peek_cqe(&ring_, &cqe) == 0) {
+    std::uint64_t user_data = io_uring_cqe_get_data64(cqe);
+    int result = cqe->res;
+    std::uint32_t flags = cqe->flags;
+    io_uring_cqe_seen(&ring_, cqe);
+    if (user_data == UNICAST_RECEIVE || user_data == MULTICAST_RECEIVE) {
+      handle_receive(static_cast<receive_tag>(user_data), result, flags);
+      continue;
+    }
+    if (result < 0) {
+      std::cerr << "[<uring_channel>]: (sendmsg) " << std::strerror(-result) << std::endl;
+    }
+    pending_sends_.erase(user_data);
+  }
+  schedule_submit();
+  wait_completions();
+}
+
+void uring_channel::handle_receive(receive_tag _tag, int _result, std::uint32_t _flags) {
+  buffer_ring& buffers = _tag == UNICAST_RECEIVE ? unicast_buffers_ : multicast_buffers_;
+  if (_result < 0) {
+    // ENOBUFS means every buffer was in use, the multishot receive terminated and is rearmed below
+    if (_result != -ENOBUFS) {
+      std::cerr << "[<uring_channel>]: (recvmsg) " << std::strerror(-_result) << std::endl;
+    }
+  } else if (_flags & IORING_CQE_F_BUFFER) {
+    std::uint16_t buffer_id = _flags >> IORING_CQE_BUFFER_SHIFT;
+    unsigned char* buffer = buffers.buffers_.get() + buffer_id * receive_buffer_length;
+    io_uring_recvmsg_out* recvmsg_out = io_uring_recvmsg_validate(buffer, _result, &receive_msghdr_);
+    if (!recvmsg_out) {
+      std::cerr << "[<uring_channel>]: (recvmsg) malformed completion" << std::endl;
+    } else if (recvmsg_out->flags & MSG_TRUNC) {
+      std::cerr << "[<uring_channel>]: (recvmsg) datagram exceeds " << receive_buffer_length << " byte receive buffer, dropped" << std::endl;
+    } else {
+      std::uint32_t& kernel_drops = _tag == UNICAST_RECEIVE ? unicast_kernel_drops_ : multicast_kernel_drops_;
+      for (cmsghdr* control = io_uring_recvmsg_cmsg_firsthdr(recvmsg_out, &receive_msghdr_); control;
+           control = io_uring_recvmsg_cmsg_nexthdr(recvmsg_out, &receive_msghdr_, control)) {
+        if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL) {
+          std::memcpy(&kernel_drops, CMSG_DATA(control), sizeof(std::uint32_t));
+        }
+      }
+      boost::asio::ip::udp::endpoint remote_endpoint;
+      std::memcpy(remote_endpoint.data(), io_uring_recvmsg_name(recvmsg_out), sizeof(sockaddr_in));
+      unsigned char* payload = static_cast<unsigned char*>(io_uring_recvmsg_payload(recvmsg_out, &receive_msghdr_));
+      size_t payload_length = io_uring_recvmsg_payload_length(recvmsg_out, _result, &receive_msghdr_);
+      mc_app_.received_data(payload, payload_length, remote_endpoint);
+    }
+    recycle_buffer(buffers, buffer_id);
+  }
+  if (!(_flags & IORING_CQE_F_MORE)) {
+    arm_receive(_tag);
+  }
+}
+
+void uring_channel::recycle_buffer(buffer_ring& _buffer_ring, std::uint16_t _buffer_id) {
+  io_uring_buf_ring_add(_buffer_ring.ring_, _buffer_ring.buffers_.get() + _buffer_id * receive_buffer_length, receive_buffer_length,
+                        _buffer_id, io_uring_buf_ring_mask(receive_buffer_count), 0);
+  io_uring_buf_ring_advance(_buffer_ring.ring_, 1);
+}
+
+void uring_channel::send_multicast(boost::asio::streambuf& _buffer) {
+  send_to(make_shared_datagram(_buffer), multicast_endpoint_);
+}
+
+void uring_channel::send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  send_to(make_shared_datagram(_buffer), _remote_endpoint);
+}
+
+void uring_channel::send_multicast(shared_datagram_t _datagram) {
+  send_to(_datagram, multicast_endpoint_);
+}
+
+void uring_channel::send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) {
+  io_uring_sqe* sqe = get_sqe();
+  if (!sqe) {
+    std::cerr << "[<uring_channel>]: (send_to) submission queue exhausted, datagram dropped" << std::endl;
+    return;
+  }
+  const std::uint64_t send_id = next_send_id_++;
+  pending_send& send = pending_sends_.emplace(send_id, pending_send{_datagram, _remote_endpoint, iovec{}, msghdr{}}).first->second;
+  // sendmsg only reads from the iovec, the shared datagram is never modified
+  send.iovec_.iov_base = const_cast<unsigned char*>(send.datagram_->data());
+  send.iovec_.iov_len = send.datagram_->size();
+  send.msghdr_.msg_name = send.remote_endpoint_.data();
+  send.msghdr_.msg_namelen = send.remote_endpoint_.size();
+  send.msghdr_.msg_iov = &send.iovec_;
+  send.msghdr_.msg_iovlen = 1;
+  io_uring_prep_sendmsg(sqe, unicast_socket_.native_handle(), &send.msghdr_, 0);
+  io_uring_sqe_set_data64(sqe, send_id);
+  schedule_submit();
+}
+
+boost::asio::ip::udp::endpoint uring_channel::get_local_endpoint() const {
+  return unicast_socket_.local_endpoint();
+}
+
+transport_statistics uring_channel::get_transport_statistics() const {
+  transport_statistics statistics;
+  statistics.kernel_drops_ = std::uint64_t(unicast_kernel_drops_) + multicast_kernel_drops_;
+  statistics.receive_queue_high_water_mark_ = receive_queue_high_water_mark_;
+  statistics.send_queue_high_water_mark_ = send_queue_high_water_mark_;
+  return statistics;
+}
+
+void uring_channel::sample_queue_lengths(boost::asio::ip::udp::socket& _socket) {
+  // Bytes currently held by the socket's receive and send queues
+  std::uint32_t meminfo[SK_MEMINFO_VARS];
+  socklen_t meminfo_length = sizeof(meminfo);
+  if (getsockopt(_socket.native_handle(), SOL_SOCKET, SO_MEMINFO, meminfo, &meminfo_length) < 0) {
+    return;
+  }
+  receive_queue_high_water_mark_ = std::max<std::uint64_t>(receive_queue_high_water_mark_, meminfo[SK_MEMINFO_RMEM_ALLOC]);
+  send_queue_high_water_mark_ = std::max<std::uint64_t>(send_queue_high_water_mark_, meminfo[SK_MEMINFO_WMEM_ALLOC]);
+}
+#endif
@@ -0,0 +1,88 @@
+#ifndef URING_CHANNEL
+#define URING_CHANNEL
+
+#ifdef IO_URING
+#include "multicast_application.hpp"
+#include "datagram_channel.hpp"
+
+#include <unordered_map>
+#include <memory>
+#include <netinet/in.h>
+#include <liburing.h>
+#include <boost/asio.hpp>
+
+// io_uring transport with the same semantics as multicast_channel. Both sockets are served by multishot recvmsg
+// operations drawing from registered buffer rings, sends are queued as sendmsg operations and submitted once per strand turn.
+// Completions are signalled through an eventfd, which is waited on by the strand, so received_data runs on the strand as before.
+// The constructor throws std::runtime_error if the kernel lacks support, the caller is expected to fall back to multicast_channel.
+class uring_channel : public datagram_channel
+{
+
+private:
+/* Member variables*/
+  // Receive buffers hold the io_uring_recvmsg_out header, the source address, the SO_RXQ_OVFL control message
+  // and one datagram of up to one MTU
+  enum { ring_entries = 256, receive_buffer_count = 256, receive_buffer_length = 2048, socket_buffer_length = 8388608 };
+  enum receive_tag : std::uint64_t { UNICAST_RECEIVE = 1, MULTICAST_RECEIVE = 2 };
+  struct buffer_ring {
+    io_uring_buf_ring* ring_;
+    std::unique_ptr<unsigned char[]> buffers_;
+    std::uint16_t group_id_;
+  };
+  struct pending_send {
+    shared_datagram_t datagram_;
+    boost::asio::ip::udp::endpoint remote_endpoint_;
+    iovec iovec_;
+    msghdr msghdr_;
+  };
+  io_uring ring_;
+  bool ring_initialized_;
+  boost::asio::ip::udp::socket unicast_socket_;
+  boost::asio::ip::udp::socket multicast_socket_;
+  boost::asio::ip::udp::endpoint multicast_endpoint_;
+  boost::asio::posix::stream_descriptor completion_event_;
+  std::uint64_t completion_event_count_;
+  buffer_ring unicast_buffers_;
+  buffer_ring multicast_buffers_;
+  msghdr receive_msghdr_;
+  std::uint32_t unicast_kernel_drops_;
+  std::uint32_t multicast_kernel_drops_;
+  std::uint64_t receive_queue_high_water_mark_;
+  std::uint64_t send_queue_high_water_mark_;
+  // Sends stay here until their completion was reaped, so the kernel never reads a released datagram.
+  // Keys start above the receive tags and double as the operation's user data
+  std::unordered_map<std::uint64_t, pending_send> pending_sends_;
+  std::uint64_t next_send_id_;
+  bool submit_scheduled_;
+  multicast_application& mc_app_;
+
+private:
+/* Methods */
+  void setup_ring();
+  void setup_buffer_ring(buffer_ring& _buffer_ring, std::uint16_t _group_id);
+  void release_ring();
+  io_uring_sqe* get_sqe();
+  void arm_receive(receive_tag _tag);
+  void schedule_submit();
+  void wait_completions();
+  void handle_completions(const boost::system::error_code& _error);
+  void handle_receive(receive_tag _tag, int _result, std::uint32_t _flags);
+  void recycle_buffer(buffer_ring& _buffer_ring, std::uint16_t _buffer_id);
+  void sample_queue_lengths(boost::asio::ip::udp::socket& _socket);
+
+public:
+  uring_channel(boost::asio::strand<boost::asio::io_service::executor_type>& _strand,
+    const boost::asio::ip::address& _listen_interface_by_address,
+    const boost::asio::ip::address& _multicast_address,
+    int _multicast_port, multicast_application& _mc_app);
+  ~uring_channel();
+  void send_multicast(boost::asio::streambuf& _buffer) override;
+  void send_to(boost::asio::streambuf& _buffer, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  void send_multicast(shared_datagram_t _datagram) override;
+  void send_to(shared_datagram_t _datagram, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+  boost::asio::ip::udp::endpoint get_local_endpoint() const override;
+  transport_statistics get_transport_statistics() const override;
+};
+#endif
+
+#endif
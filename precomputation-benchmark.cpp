@@ -0,0 +1,88 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cryptopp/dh.h>
+#include <cryptopp/eccrypto.h>
+#include <cryptopp/oids.h>
+#include <cryptopp/osrng.h>
+#include "MODP2048_256sg.hpp"
+#include "group_precomputation.hpp"
+#include "primitives.hpp"
+
+// Latency of GeneratePublicKey (exponentiation of the fixed generator) with and without the fixed-base
+// precomputation tables of group_precomputation, for secp256r1 and the 2048-bit MODP group.
+
+template <typename T>
+double measure_public_key_generation(const T& _diffie_hellman, const std::vector<secret_t>& _secrets, std::vector<blinded_secret_t>& _blinded_secrets) {
+    CryptoPP::AutoSeededRandomPool rng;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < _secrets.size(); i++) {
+        _diffie_hellman.GeneratePublicKey(rng, _secrets[i], _blinded_secrets[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / _secrets.size();
+}
+
+template <typename T>
+bool run(const std::string& _group_name, T& _plain_diffie_hellman, T& _precomputed_diffie_hellman, size_t _iterations, unsigned int _storage) {
+    CryptoPP::AutoSeededRandomPool rng;
+    std::vector<secret_t> secrets(_iterations);
+    std::vector<blinded_secret_t> plain_blinded_secrets(_iterations);
+    std::vector<blinded_secret_t> precomputed_blinded_secrets(_iterations);
+    for (size_t i = 0; i < _iterations; i++) {
+        secrets[i].New(_plain_diffie_hellman.PrivateKeyLength());
+        _plain_diffie_hellman.GeneratePrivateKey(rng, secrets[i]);
+        plain_blinded_secrets[i].New(_plain_diffie_hellman.PublicKeyLength());
+        precomputed_blinded_secrets[i].New(_plain_diffie_hellman.PublicKeyLength());
+    }
+
+    double without_tables_us = measure_public_key_generation(_plain_diffie_hellman, secrets, plain_blinded_secrets);
+    auto build_start = std::chrono::steady_clock::now();
+    _precomputed_diffie_hellman.AccessGroupParameters().Precompute(_storage);
+    auto build_end = std::chrono::steady_clock::now();
+    double with_tables_us = measure_public_key_generation(_precomputed_diffie_hellman, secrets, precomputed_blinded_secrets);
+
+    std::cout << _group_name << "," << _storage << "," << std::fixed << std::setprecision(1) << without_tables_us << "," << with_tables_us << ","
+              << std::setprecision(2) << without_tables_us / with_tables_us << ","
+              << std::setprecision(1) << std::chrono::duration<double, std::milli>(build_end - build_start).count() << std::endl;
+    for (size_t i = 0; i < _iterations; i++) {
+        if (plain_blinded_secrets[i] != precomputed_blinded_secrets[i]) {
+            std::cerr << "[<precomputation_benchmark>]: " << _group_name << " public keys differ with precomputation" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 200;
+    unsigned int storage = group_precomputation::storage;
+    try {
+        if (argc > 1) {
+            iterations = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            storage = std::stoul(argv[2]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Usage: " << argv[0] << " [iterations] [storage]" << std::endl;
+        return 1;
+    }
+    if (iterations == 0 || storage == 0) {
+        std::cerr << "iterations and storage must be greater than 0" << std::endl;
+        return 1;
+    }
+
+    std::cout << "group,storage,without_tables_us,with_tables_us,speedup,build_ms" << std::endl;
+    CryptoPP::ECDH<CryptoPP::ECP>::Domain plain_ecc_diffie_hellman, precomputed_ecc_diffie_hellman;
+    plain_ecc_diffie_hellman.AccessGroupParameters().Initialize(CryptoPP::ASN1::secp256r1());
+    precomputed_ecc_diffie_hellman.AccessGroupParameters().Initialize(CryptoPP::ASN1::secp256r1());
+    CryptoPP::DH plain_default_diffie_hellman, precomputed_default_diffie_hellman;
+    plain_default_diffie_hellman.AccessGroupParameters().Initialize(P, Q, G);
+    precomputed_default_diffie_hellman.AccessGroupParameters().Initialize(P, Q, G);
+    bool succeeded = run("ECC_DH", plain_ecc_diffie_hellman, precomputed_ecc_diffie_hellman, iterations, storage);
+    succeeded = run("DEFAULT_DH", plain_default_diffie_hellman, precomputed_default_diffie_hellman, iterations, storage) && succeeded;
+    return succeeded ? 0 : 1;
+}
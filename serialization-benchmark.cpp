@@ -0,0 +1,248 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include <cryptopp/aes.h>
+#include <cryptopp/dh.h>
+#include <cryptopp/eccrypto.h>
+#include <cryptopp/oids.h>
+#include <cryptopp/osrng.h>
+#include <cryptopp/xed25519.h>
+#include "MODP2048_256sg.hpp"
+#include "key_agreement_protocol.hpp"
+#include "message_handler.hpp"
+#include "primitives.hpp"
+
+// Measures encoding and decoding of every message type through message_handler::serialize (into a reused vector, as the
+// protocols send) and deserialize_and_callback, apart from crypto and network. Blinded and group secrets are sized after
+// the public key and agreed value lengths of each group, so ECC_DH, DEFAULT_DH and X25519_DH payloads are compared in one run.
+
+static std::atomic<size_t> allocation_count(0);
+
+void* operator new(size_t _size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(_size ? _size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* _pointer) noexcept {
+    std::free(_pointer);
+}
+
+void operator delete(void* _pointer, size_t) noexcept {
+    std::free(_pointer);
+}
+
+struct group_sizes {
+    std::string name_;
+    size_t blinded_secret_length_;
+    size_t group_secret_length_;
+};
+
+class serialization_benchmark : public key_agreement_protocol {
+    public:
+        typedef handled_messages<find_message, offer_message, request_message, response_message, member_info_request_message, member_info_response_message,
+                                 synch_token_message, member_info_synch_request_message, member_info_synch_response_message, distributed_response_message,
+                                 finish_message, finish_ack_message, blinded_key_message> handled_messages_t;
+
+        serialization_benchmark(size_t _iterations, member_id_t _requested_member_count) : iterations_(_iterations), message_handler_(std::make_unique<message_handler<serialization_benchmark>>(this)), decoded_count_(0), expected_decoded_count_(0) {
+            for (member_id_t member_id = 1; member_id <= _requested_member_count; member_id++) {
+                requested_members_.insert(member_id);
+            }
+        }
+
+        void run(const group_sizes& _group) {
+            std::vector<unsigned char> bytes(std::max(_group.blinded_secret_length_, _group.group_secret_length_));
+            CryptoPP::AutoSeededRandomPool().GenerateBlock(bytes.data(), bytes.size());
+            byte_view_t blinded_secret(bytes.data(), _group.blinded_secret_length_);
+            byte_view_t group_secret(bytes.data(), _group.group_secret_length_);
+            byte_view_t initialization_vector(bytes.data(), CryptoPP::AES::BLOCKSIZE);
+
+            find_message find;
+            find.required_service_ = DEFAULT_SERVICE_ID;
+            measure(_group, "find", find);
+
+            offer_message offer;
+            offer.offered_service_ = DEFAULT_SERVICE_ID;
+            measure(_group, "offer", offer);
+
+            request_message request;
+            request.required_service_ = DEFAULT_SERVICE_ID;
+            request.blinded_secret_ = blinded_secret;
+            measure(_group, "request", request);
+
+            response_message response;
+            response.offered_service_ = DEFAULT_SERVICE_ID;
+            response.blinded_sponsor_secret_ = blinded_secret;
+            response.blinded_group_secret_ = blinded_secret;
+            response.new_sponsor.endpoint_ = boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), 65000);
+            response.new_sponsor.assigned_id_ = 1;
+            response.new_sponsor.blinded_secret_ = blinded_secret;
+            measure(_group, "response", response);
+
+            member_info_request_message member_info_request;
+            member_info_request.required_service_ = DEFAULT_SERVICE_ID;
+            member_info_request.requested_members_ = requested_members_;
+            measure(_group, "member_info_request", member_info_request);
+
+            member_info_response_message member_info_response;
+            member_info_response.offered_service_ = DEFAULT_SERVICE_ID;
+            member_info_response.member_id_ = 1;
+            member_info_response.blinded_secret_ = blinded_secret;
+            measure(_group, "member_info_response", member_info_response);
+
+            synch_token_message synch_token;
+            synch_token.member_id_ = 1;
+            measure(_group, "synch_token", synch_token);
+
+            member_info_synch_request_message member_info_synch_request;
+            member_info_synch_request.required_service_ = DEFAULT_SERVICE_ID;
+            member_info_synch_request.requested_members_ = requested_members_;
+            measure(_group, "member_info_synch_request", member_info_synch_request);
+
+            member_info_synch_response_message member_info_synch_response;
+            member_info_synch_response.offered_service_ = DEFAULT_SERVICE_ID;
+            member_info_synch_response.member_id_ = 1;
+            member_info_synch_response.blinded_secret_ = blinded_secret;
+            measure(_group, "member_info_synch_response", member_info_synch_response);
+
+            // CFB mode keeps the length of the encrypted group secret
+            distributed_response_message distributed_response;
+            distributed_response.offered_service_ = DEFAULT_SERVICE_ID;
+            distributed_response.blinded_sponsor_secret_ = blinded_secret;
+            distributed_response.encrypted_group_secret_ = group_secret;
+            distributed_response.initialization_vector_ = initialization_vector;
+            measure(_group, "distributed_response", distributed_response);
+
+            finish_message finish;
+            measure(_group, "finish", finish);
+
+            finish_ack_message finish_ack;
+            measure(_group, "finish_ack", finish_ack);
+
+            blinded_key_message blinded_key;
+            blinded_key.offered_service_ = DEFAULT_SERVICE_ID;
+            blinded_key.node_id_ = 2;
+            blinded_key.blinded_key_ = blinded_secret;
+            measure(_group, "blinded_key", blinded_key);
+        }
+
+        void print_header() {
+            std::cout << "group,message,bytes,encode_ns,decode_ns,encode_mb_per_s,decode_mb_per_s,encode_allocations,decode_allocations" << std::endl;
+        }
+
+        void process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_response(const response_message& _rcvd_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_member_info_request(const member_info_request_message& _rcvd_member_info_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_member_info_response(const member_info_response_message& _rcvd_member_info_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_synch_token(const synch_token_message& _rcvd_synch_token_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_member_info_synch_request(const member_info_synch_request_message& _rcvd_member_info_synch_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_member_info_synch_response(const member_info_synch_response_message& _rcvd_member_info_synch_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_distributed_response(const distributed_response_message& _rcvd_distributed_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+        void process_blinded_key(const blinded_key_message& _rcvd_blinded_key_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) { decoded(); }
+
+        bool verify() const {
+            // Every decode has to reach its process_* method, otherwise the decode timings are meaningless
+            return decoded_count_ == expected_decoded_count_;
+        }
+    private:
+        size_t iterations_;
+        std::unique_ptr<message_handler<serialization_benchmark>> message_handler_;
+        wire_bitmap<member_id_t> requested_members_;
+        boost::asio::ip::udp::endpoint remote_endpoint_;
+        size_t decoded_count_;
+        size_t expected_decoded_count_;
+
+        void decoded() {
+            decoded_count_++;
+        }
+
+        void measure(const group_sizes& _group, const std::string& _message_name, const message& _message) {
+            // Encoded through the vector overload the protocols send with. The buffer keeps its capacity like a recycled
+            // send_buffer_pool buffer, warmed up once
+            std::vector<unsigned char> buffer;
+            message_handler_->serialize(_message, buffer);
+            const size_t bytes = buffer.size();
+
+            size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+            auto encode_start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations_; i++) {
+                message_handler_->serialize(_message, buffer);
+            }
+            auto encode_end = std::chrono::steady_clock::now();
+            size_t encode_allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+
+            const std::vector<unsigned char> datagram(buffer);
+            byte_view_t datagram_view(datagram);
+
+            allocations_before = allocation_count.load(std::memory_order_relaxed);
+            auto decode_start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations_; i++) {
+                message_handler_->deserialize_and_callback(datagram_view, remote_endpoint_);
+            }
+            auto decode_end = std::chrono::steady_clock::now();
+            size_t decode_allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+            expected_decoded_count_ += iterations_;
+
+            double encode_ns = std::chrono::duration<double, std::nano>(encode_end - encode_start).count() / iterations_;
+            double decode_ns = std::chrono::duration<double, std::nano>(decode_end - decode_start).count() / iterations_;
+            std::cout << _group.name_ << "," << _message_name << "," << bytes << ","
+                      << std::fixed << std::setprecision(1) << encode_ns << "," << decode_ns << ","
+                      << bytes * 1e3 / encode_ns << "," << bytes * 1e3 / decode_ns << ","
+                      << std::setprecision(2) << static_cast<double>(encode_allocations) / iterations_ << ","
+                      << static_cast<double>(decode_allocations) / iterations_ << std::endl;
+        }
+};
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 100000;
+    member_id_t requested_member_count = 100;
+    try {
+        if (argc > 1) {
+            iterations = std::stoul(argv[1]);
+        }
+        if (argc > 2) {
+            requested_member_count = static_cast<member_id_t>(std::stoul(argv[2]));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Usage: " << argv[0] << " [iterations] [requested member count]" << std::endl;
+        return 1;
+    }
+    if (iterations == 0) {
+        std::cerr << "iterations must be greater than 0" << std::endl;
+        return 1;
+    }
+
+    CryptoPP::ECDH<CryptoPP::ECP>::Domain ecc_diffie_hellman;
+    ecc_diffie_hellman.AccessGroupParameters().Initialize(CryptoPP::ASN1::secp256r1());
+    CryptoPP::DH default_diffie_hellman;
+    default_diffie_hellman.AccessGroupParameters().Initialize(P, Q, G);
+    CryptoPP::x25519 x25519_diffie_hellman;
+    std::vector<group_sizes> groups = {
+        {"ECC_DH", ecc_diffie_hellman.PublicKeyLength(), ecc_diffie_hellman.AgreedValueLength()},
+        {"ECC_DH+COMPRESSED_POINTS", ecc_diffie_hellman.GetGroupParameters().GetCurve().EncodedPointSize(true), ecc_diffie_hellman.AgreedValueLength()},
+        {"DEFAULT_DH", default_diffie_hellman.PublicKeyLength(), default_diffie_hellman.AgreedValueLength()},
+        {"X25519_DH", x25519_diffie_hellman.PublicKeyLength(), x25519_diffie_hellman.AgreedValueLength()}
+    };
+
+    serialization_benchmark benchmark(iterations, requested_member_count);
+    benchmark.print_header();
+    for (const group_sizes& group : groups) {
+        benchmark.run(group);
+    }
+    if (!benchmark.verify()) {
+        std::cerr << "[<serialization_benchmark>]: Not every encoded message was decoded" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,33 +1,20 @@
 #include "statistics_writer.hpp"
 #include "logger.hpp"
+#include "command_line_flags.hpp"
 #include <memory>
 
 int main (int argc, char* argv[]) {
-    if(argc != 3) {
-      std::cerr << "Usage: " + std::string(argv[0]) + " <member_count> <absolute_results_directory_path>\n";
-      std::cerr << "  Example: " + std::string(argv[0]) + " 20 /path/to/results/directory\n";
+    command_line_flags flags(argc, argv);
+    argc = flags.get_argc();
+    argv = flags.get_argv();
+    if(argc != 3 || !flags.is_valid()) {
+      std::cerr << "Usage: " + std::string(argv[0]) + " <member_count> <absolute_results_directory_path> " + command_line_flags::usage() + "\n";
+      std::cerr << "  Example: " + std::string(argv[0]) + " 20 /path/to/results/directory --protocol=PROTO_DST_DH --crypto=X25519_DH\n";
       return 1;
     }
     std::uint32_t member_count = std::stoi(argv[1]);
     std::string absolute_results_directory_path(argv[2]);
-    std::string result_filename;
-
-#ifdef PROTO_STR_DH
-    result_filename = "PROTO_STR_DH";
-#elif defined(PROTO_DST_DH)
-    result_filename = "PROTO_DST_DH";
-#else
-    std::cerr << "No key agreement algortihm defined, add PROTO_STR_DH or PROTO_DST_DH to compile definitions"
-    return 1;
-#endif
-#ifdef ECC_DH
-    result_filename += "-ECC_DH";
-#elif defined(DEFAULT_DH)
-    result_filename += "-DEFAULT_DH";
-#else
-    std::cerr << "No crypto algorithm defined, add ECC_DH or DEFAULT_DH to compile definitions"
-    return 1;
-#endif
+    std::string result_filename = flags.get_protocol() + "-" + flags.get_crypto_algorithm();
 #ifdef RETRANSMISSIONS
     result_filename += "-RTX";
 #endif
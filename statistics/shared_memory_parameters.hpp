@@ -13,6 +13,10 @@
 #define FINISH_ACK_MESSAGE_COUNT                "FINISH_ACK_MESSAGE_COUNT"
 #define DISTRIBUTED_RESPONSE_MESSAGE_COUNT      "DISTRIBUTED_RESPONSE_MESSAGE_COUNT"
 #define CRYPTO_OPERATIONS_COUNT                 "CRYPTO_OPERATIONS_COUNT"
+#define KERNEL_DROP_COUNT                       "KERNEL_DROP_COUNT"
+#define RECEIVE_QUEUE_HIGH_WATER_MARK           "RECEIVE_QUEUE_HIGH_WATER_MARK"
+#define SEND_QUEUE_HIGH_WATER_MARK              "SEND_QUEUE_HIGH_WATER_MARK"
+#define BLINDED_KEY_MESSAGE_COUNT               "BLINDED_KEY_MESSAGE_COUNT"
 #define DURATION_START                          "DURATION_START"
 #define DURATION_END                            "DURATION_END"
 #define KEY_AGREEMENT_START                     "KEY_AGREEMENT_START"
@@ -59,7 +63,12 @@ enum count_metric {
     FINISH_ACK_MESSAGE_COUNT_,
     DISTRIBUTED_RESPONSE_MESSAGE_COUNT_,
     CRYPTO_OPERATIONS_COUNT_,
-    COUNT_SIZE = CRYPTO_OPERATIONS_COUNT_+1
+    KERNEL_DROP_COUNT_,
+    RECEIVE_QUEUE_HIGH_WATER_MARK_,
+    SEND_QUEUE_HIGH_WATER_MARK_,
+    // Count columns precede the time columns in the CSV, so every new count shifts the time columns: read columns by name
+    BLINDED_KEY_MESSAGE_COUNT_,
+    COUNT_SIZE = BLINDED_KEY_MESSAGE_COUNT_+1
 };
 enum time_metric {
     DURATION_START_,
@@ -15,6 +15,10 @@ statistics_recorder* statistics_recorder::get_instance() {
     return instance_;
 }
 
+statistics_recorder* statistics_recorder::create_instance() {
+    return new statistics_recorder();
+}
+
 statistics_recorder::statistics_recorder() {
 }
 
@@ -28,8 +32,15 @@ void statistics_recorder::record_timestamp(time_metric _time_metric) {
     time_statistics_[_time_metric] = std::chrono::system_clock::now().time_since_epoch().count();
 }
 
-void statistics_recorder::record_count(count_metric _count_metric) {
-    count_statistics_[_count_metric]++;
+void statistics_recorder::record_count(count_metric _count_metric, metric_value _count) {
+    count_statistics_[_count_metric] += _count;
+}
+
+void statistics_recorder::record_maximum(count_metric _count_metric, metric_value _value) {
+    maximum_metrics_.insert(_count_metric);
+    if (count_statistics_[_count_metric] < _value) {
+        count_statistics_[_count_metric] = _value;
+    }
 }
 
 void statistics_recorder::contribute_statistics() {
@@ -54,7 +65,13 @@ void statistics_recorder::contribute_statistics() {
                 if(!(*composite_count_statistics_).count(pair.first)) {
                     (*composite_count_statistics_)[pair.first] = 0;
                 }
-                (*composite_count_statistics_)[pair.first] += pair.second;
+                if(maximum_metrics_.count(pair.first)) {
+                    if((*composite_count_statistics_)[pair.first] < pair.second) {
+                        (*composite_count_statistics_)[pair.first] = pair.second;
+                    }
+                } else {
+                    (*composite_count_statistics_)[pair.first] += pair.second;
+                }
             }
             for(std::pair<metric_id, metric_value> pair : time_statistics_) {
 #ifdef RETRANSMISSIONS
@@ -3,12 +3,18 @@
 
 #include "shared_memory_parameters.hpp"
 
+#include <unordered_set>
+
 class statistics_recorder
 {
 public:
     static statistics_recorder* get_instance();
+    // Separate recorder per member when several members share one process (in-memory simulation)
+    static statistics_recorder* create_instance();
     void record_timestamp(time_metric _time_metric);
-    void record_count(count_metric _count_metric);
+    void record_count(count_metric _count_metric, metric_value _count = 1);
+    // Composed as the maximum over all members instead of their sum
+    void record_maximum(count_metric _count_metric, metric_value _value);
     void contribute_statistics();
     ~statistics_recorder();
 private:
@@ -16,6 +22,7 @@ private:
     static statistics_recorder* instance_;
     std::unordered_map<metric_id, metric_value> count_statistics_;
     std::unordered_map<metric_id, metric_value> time_statistics_;
+    std::unordered_set<metric_id> maximum_metrics_;
     shared_statistics_map* composite_count_statistics_;
     shared_statistics_map* composite_time_statistics_;
     statistics_recorder();
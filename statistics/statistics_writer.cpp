@@ -35,6 +35,10 @@ statistics_writer::statistics_writer() {
     count_metric_names_[count_metric::FINISH_ACK_MESSAGE_COUNT_] = FINISH_ACK_MESSAGE_COUNT;
     count_metric_names_[count_metric::DISTRIBUTED_RESPONSE_MESSAGE_COUNT_] = DISTRIBUTED_RESPONSE_MESSAGE_COUNT;
     count_metric_names_[count_metric::CRYPTO_OPERATIONS_COUNT_] = CRYPTO_OPERATIONS_COUNT;
+    count_metric_names_[count_metric::KERNEL_DROP_COUNT_] = KERNEL_DROP_COUNT;
+    count_metric_names_[count_metric::RECEIVE_QUEUE_HIGH_WATER_MARK_] = RECEIVE_QUEUE_HIGH_WATER_MARK;
+    count_metric_names_[count_metric::SEND_QUEUE_HIGH_WATER_MARK_] = SEND_QUEUE_HIGH_WATER_MARK;
+    count_metric_names_[count_metric::BLINDED_KEY_MESSAGE_COUNT_] = BLINDED_KEY_MESSAGE_COUNT;
     time_metric_names_[time_metric::DURATION_START_] = DURATION_START;
     time_metric_names_[time_metric::DURATION_END_] = DURATION_END;
     time_metric_names_[time_metric::KEY_AGREEMENT_START_] = KEY_AGREEMENT_START;
@@ -1,31 +1,34 @@
 #include "str_dh.hpp"
-#include "MODP2048_256sg.hpp"
 
 #include <random>
+#include <sstream>
 #include <cryptopp/nbtheory.h>
 #include <cryptopp/oids.h>
 #include <cryptopp/asn.h>
 
-#define UNINITIALIZED_ADDRESS "0.0.0.0"
-
-str_dh::str_dh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port) : is_sponsor_(_is_sponsor), request_scheduled_(false), response_scheduled_(false), higher_member_id_synching_(false), higher_member_id_assigned_(false), synch_token_rcvd_(false), synch_finished_(false), last_member_synch_token_sending_triggered_(false), finish_message_rcvd_(false), service_of_interest_(_service_id), member_count_(_member_count), multicast_application_impl(_listening_interface_by_ip, _multicast_ip, _multicast_port), message_handler_(std::make_unique<message_handler>(this)), statistics_recorder_(statistics_recorder::get_instance()), scatter_timer_(multicast_application_impl::get_io_service()), timeout_timer_(multicast_application_impl::get_io_service()) {
+template <typename group_t>
+str_dh<group_t>::str_dh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count, std::uint32_t _send_rate, in_memory_bus* _in_memory_bus) : is_sponsor_(_is_sponsor), request_scheduled_(false), response_scheduled_(false), higher_member_id_synching_(false), higher_member_id_assigned_(false), synch_token_rcvd_(false), synch_finished_(false), last_member_synch_token_sending_triggered_(false), finish_message_rcvd_(false), service_of_interest_(_service_id), member_count_(_member_count), multicast_application_impl(_listening_interface_by_ip, _multicast_ip, _multicast_port, _worker_thread_count, _send_rate, _in_memory_bus), message_handler_(std::make_unique<message_handler<str_dh>>(this)), statistics_recorder_(_in_memory_bus ? statistics_recorder::create_instance() : statistics_recorder::get_instance()), scatter_timer_(multicast_application_impl::get_strand()), timeout_timer_(multicast_application_impl::get_strand()) {
     if (is_sponsor_) {
         statistics_recorder_->record_timestamp(time_metric::DURATION_START_);
     }
 #ifdef RETRANSMISSIONS
     scatter_delay_ = compute_scatter_delay(_scatter_delay_min, _scatter_delay_max);
 #endif
-#ifdef DEFAULT_DH
-    diffie_hellman_.AccessGroupParameters().Initialize(P, Q, G);
-    LOG_DEBUG("[<str_dh>]: Using default DH")
-#elif defined(ECC_DH)
-    diffie_hellman_.AccessGroupParameters().Initialize(CryptoPP::ASN1::secp256r1());
-    LOG_DEBUG("[<str_dh>]: Using ECDH")
-#endif
-    secret_.New(diffie_hellman_.PrivateKeyLength());
-    blinded_secret_.New(diffie_hellman_.PublicKeyLength());
-    diffie_hellman_.GeneratePrivateKey(rng_, secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
-    diffie_hellman_.GeneratePublicKey(rng_, secret_, blinded_secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    group_t::initialize(diffie_hellman_);
+    point_codec_.initialize(diffie_hellman_);
+    LOG_DEBUG("[<str_dh>]: Using " << group_t::name_)
+    // Members of an in-memory simulation pull key pairs that were generated in the background while the members before them were constructed
+    key_pair_pool<typename group_t::domain_t>* pregenerated_key_pairs = _in_memory_bus ? key_pair_pool<typename group_t::domain_t>::get_instance(diffie_hellman_, member_count_, _worker_thread_count) : nullptr;
+    if (!pregenerated_key_pairs || !pregenerated_key_pairs->pull(secret_, blinded_secret_)) {
+        secret_.New(diffie_hellman_.PrivateKeyLength());
+        blinded_secret_.New(diffie_hellman_.PublicKeyLength());
+        diffie_hellman_.GeneratePrivateKey(rng_, secret_);
+        diffie_hellman_.GeneratePublicKey(rng_, secret_, blinded_secret_);
+    }
+    // Pulled pairs are counted as well, they were generated for this member
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    wire_blinded_secret_ = point_codec_.to_wire(blinded_secret_);
 
     str_key_tree_map_.clear();
     pending_requests_.clear();
@@ -37,40 +40,57 @@ str_dh::str_dh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member
         member_id_ = INITIAL_SPONSOR_ID;
         keys_computed_count_ = 1;
         str_key_tree_map_[service_of_interest_] = build_str_tree(secret_, blinded_secret_, secret_, blinded_secret_);
-        std::unique_ptr<offer_message> initial_offer = std::make_unique<offer_message>();
-        initial_offer->offered_service_ = service_of_interest_;
-        send(initial_offer.operator*()); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+        offer_message initial_offer;
+        initial_offer.offered_service_ = service_of_interest_;
+        send(initial_offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
 #ifdef RETRANSMISSIONS
         send_cyclic_offer();
 #endif
     } else {
         keys_computed_count_ = 0;
-        // std::unique_ptr<find_message> initial_find = std::make_unique<find_message>();
-        // initial_find->required_service_ = service_of_interest_;
-        // send(initial_find.operator*()); statistics_recorder_->record_count(count_metric::FIND_MESSAGE_COUNT_);
+        // find_message initial_find;
+        // initial_find.required_service_ = service_of_interest_;
+        // send(initial_find); statistics_recorder_->record_count(count_metric::FIND_MESSAGE_COUNT_);
     }
 }
 
-str_dh::~str_dh() {
+template <typename group_t>
+str_dh<group_t>::~str_dh() {
 
 }
 
-void str_dh::received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    std::lock_guard<std::mutex> lock_receive(receive_mutex_);
+template <typename group_t>
+void str_dh<group_t>::received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) {
+    // Runs on the strand, so no further locking of the protocol state is needed
     if (get_local_endpoint().port() != _remote_endpoint.port()) {
-        message_handler_->deserialize_and_callback(_data, _bytes_recvd, _remote_endpoint);
+        message_handler_->deserialize_and_callback(byte_view_t(_data, _bytes_recvd), _remote_endpoint);
     }
 }
 
-void str_dh::process_find(find_message _rcvd_find_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+bool str_dh<group_t>::is_relevant(const message_header& _header) {
+    // Members only take part in the key agreement of their service of interest
+    if (_header.service_id_ != ANY_SERVICE_ID && _header.service_id_ != service_of_interest_) {
+        return false;
+    }
+    // A synch token passed to another member only sets the higher_member_id_* flags, which are never reset
+    if (_header.message_type_ == message_type::SYNCH_TOKEN && _header.target_member_id_ != member_id_) {
+        return !higher_member_id_assigned_ || (!higher_member_id_synching_ && _header.target_member_id_ > (member_id_ % member_count_));
+    }
+    return true;
+}
+
+template <typename group_t>
+void str_dh<group_t>::process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (is_sponsor_ && service_of_interest_ == _rcvd_find_message.required_service_) {
-        std::unique_ptr<offer_message> offer = std::make_unique<offer_message>();
-        offer->offered_service_ = service_of_interest_;
-        send(offer.operator*()); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+        offer_message offer;
+        offer.offered_service_ = service_of_interest_;
+        send(offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
     }
 }
 
-void str_dh::process_offer(offer_message _rcvd_offer_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
 #ifdef RETRANSMISSIONS
     check_if_higher_member_id_assigned(_remote_endpoint);
 #endif
@@ -80,26 +100,27 @@ void str_dh::process_offer(offer_message _rcvd_offer_message, boost::asio::ip::u
         scatter_timer_.expires_from_now(scatter_delay_);
         scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
             if (!_error) {
-                std::unique_ptr<request_message> request = std::make_unique<request_message>();
-                request->blinded_secret_ = blinded_secret_;
-                request->required_service_ = service_of_interest_;
-                send(request.operator*()); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
+                request_message request;
+                request.blinded_secret_ = wire_blinded_secret_;
+                request.required_service_ = service_of_interest_;
+                send(request); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
             }
             request_scheduled_ = !request_scheduled_;
         });
 #else
-        std::unique_ptr<request_message> request = std::make_unique<request_message>();
-        request->blinded_secret_ = blinded_secret_;
-        request->required_service_ = service_of_interest_;
-        send(request.operator*()); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
+        request_message request;
+        request.blinded_secret_ = wire_blinded_secret_;
+        request.required_service_ = service_of_interest_;
+        send(request); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
 #endif
     }
 }
 
-void str_dh::process_request(request_message _rcvd_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (!assigned_member_endpoint_map_[_rcvd_request_message.required_service_].contains(_remote_endpoint)
         && !pending_requests_[_rcvd_request_message.required_service_].contains(_remote_endpoint)) {
-        pending_requests_[_rcvd_request_message.required_service_][_remote_endpoint] = _rcvd_request_message.blinded_secret_;
+        pending_requests_[_rcvd_request_message.required_service_][_remote_endpoint] = point_codec_.from_wire(_rcvd_request_message.blinded_secret_);
     }
 
     if(member_id_ == INITIAL_SPONSOR_ID && is_sponsor_) {
@@ -111,27 +132,31 @@ void str_dh::process_request(request_message _rcvd_request_message, boost::asio:
 #endif
 }
 
-void str_dh::process_response(response_message _rcvd_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    boost::asio::ip::udp::endpoint new_sponsor_endpoint(_rcvd_response_message.new_sponsor.ip_address_, _rcvd_response_message.new_sponsor.port_);
+template <typename group_t>
+void str_dh<group_t>::process_response(const response_message& _rcvd_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    const boost::asio::ip::udp::endpoint& new_sponsor_endpoint = _rcvd_response_message.new_sponsor.endpoint_;
     // Add new assigned sponsor
     if (new_sponsor_endpoint != get_local_endpoint() && !assigned_member_endpoint_map_[_rcvd_response_message.offered_service_].contains(new_sponsor_endpoint)) {
-        assigned_member_key_map_[_rcvd_response_message.offered_service_][_rcvd_response_message.new_sponsor.assigned_id_] = _rcvd_response_message.new_sponsor.blinded_secret_;
+        assigned_member_key_map_[_rcvd_response_message.offered_service_][_rcvd_response_message.new_sponsor.assigned_id_] = point_codec_.from_wire(_rcvd_response_message.new_sponsor.blinded_secret_);
         assigned_member_endpoint_map_[_rcvd_response_message.offered_service_][new_sponsor_endpoint] = _rcvd_response_message.new_sponsor.assigned_id_;
     }
     // Add old assigned sponsor
     if (!assigned_member_endpoint_map_[_rcvd_response_message.offered_service_].contains(_remote_endpoint)) {
-        assigned_member_key_map_[_rcvd_response_message.offered_service_][_rcvd_response_message.new_sponsor.assigned_id_-1] = _rcvd_response_message.blinded_sponsor_secret_;
+        assigned_member_key_map_[_rcvd_response_message.offered_service_][_rcvd_response_message.new_sponsor.assigned_id_-1] = point_codec_.from_wire(_rcvd_response_message.blinded_sponsor_secret_);
         assigned_member_endpoint_map_[_rcvd_response_message.offered_service_][_remote_endpoint] = _rcvd_response_message.new_sponsor.assigned_id_-1;
     }
     pending_requests_[_rcvd_response_message.offered_service_].erase(new_sponsor_endpoint);
     pending_requests_[_rcvd_response_message.offered_service_].erase(_remote_endpoint);
 
     bool become_sponsor = get_local_endpoint() == new_sponsor_endpoint;
-    if (!is_assigned() && become_sponsor && _rcvd_response_message.offered_service_ == service_of_interest_) {
+    // Only decoded when becoming sponsor, it is passed to Crypto++ as a raw pointer, so its size is checked first
+    blinded_secret_t blinded_previous_group_secret;
+    if (!is_assigned() && become_sponsor && _rcvd_response_message.offered_service_ == service_of_interest_
+        && (blinded_previous_group_secret = point_codec_.from_wire(_rcvd_response_message.blinded_group_secret_)).SizeInBytes() == diffie_hellman_.PublicKeyLength()) {
         is_sponsor_ = true;
         member_id_ = _rcvd_response_message.new_sponsor.assigned_id_;
         secret_t group_secret(diffie_hellman_.AgreedValueLength());
-        diffie_hellman_.Agree(group_secret, secret_, _rcvd_response_message.blinded_group_secret_); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+        diffie_hellman_.Agree(group_secret, secret_, blinded_previous_group_secret); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
         blinded_secret_t blinded_group_secret(diffie_hellman_.PublicKeyLength());
         diffie_hellman_.GeneratePublicKey(rng_, group_secret, blinded_group_secret); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
         std::unique_ptr<str_key_tree> str_tree = build_str_tree(group_secret,
@@ -139,9 +164,9 @@ void str_dh::process_response(response_message _rcvd_response_message, boost::as
                                                                 secret_,
                                                                 blinded_secret_);
         std::unique_ptr<str_key_tree> previous_str_tree = build_str_tree(DEFAULT_SECRET,
-                                                                        _rcvd_response_message.blinded_group_secret_,
+                                                                        blinded_previous_group_secret,
                                                                         DEFAULT_SECRET,
-                                                                        _rcvd_response_message.blinded_sponsor_secret_);
+                                                                        point_codec_.from_wire(_rcvd_response_message.blinded_sponsor_secret_));
         str_tree->next_internal_node_ = std::move(previous_str_tree);
         str_key_tree_map_[service_of_interest_] = std::move(str_tree);
 
@@ -167,19 +192,22 @@ void str_dh::process_response(response_message _rcvd_response_message, boost::as
 #endif
 }
 
-void str_dh::process_member_info_request(member_info_request_message _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_member_info_request(const member_info_request_message& _rcvd_member_info_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     check_if_higher_member_id_assigned(_remote_endpoint);
     process_member_info_request_<member_info_request_message, member_info_response_message>(_rcvd_member_info_request_message, _remote_endpoint);
 }
 
-void str_dh::process_member_info_response(member_info_response_message _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_member_info_response(const member_info_response_message& _rcvd_member_info_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     process_member_info_response_<member_info_response_message>(_rcvd_member_info_response_message, _remote_endpoint);
     if (is_sponsor_ && all_predecessors_known()) {
         process_pending_request();
     }
 }
 
-void str_dh::process_synch_token(synch_token_message _rcvd_synch_token_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_synch_token(const synch_token_message& _rcvd_synch_token_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     higher_member_id_assigned_ = true;
     if (!higher_member_id_synching_ && _rcvd_synch_token_message.member_id_ > (member_id_ % member_count_)) { higher_member_id_synching_ = true; }
     bool synch = !synch_token_rcvd_ && _rcvd_synch_token_message.member_id_ == member_id_ && !is_last_member();
@@ -202,13 +230,15 @@ void str_dh::process_synch_token(synch_token_message _rcvd_synch_token_message,
     }
 }
 
-void str_dh::process_member_info_synch_request(member_info_synch_request_message _rcvd_member_info_synch_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_member_info_synch_request(const member_info_synch_request_message& _rcvd_member_info_synch_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     higher_member_id_assigned_ = true;
     if (!higher_member_id_synching_ && assigned_member_endpoint_map_[service_of_interest_].count(_remote_endpoint) && assigned_member_endpoint_map_[service_of_interest_][_remote_endpoint] > (member_id_ % member_count_)) { higher_member_id_synching_ = true; }
     process_member_info_request_<member_info_synch_request_message, member_info_synch_response_message>(_rcvd_member_info_synch_request_message, _remote_endpoint);
 }
 
-void str_dh::process_member_info_synch_response(member_info_synch_response_message _rcvd_member_info_synch_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_member_info_synch_response(const member_info_synch_response_message& _rcvd_member_info_synch_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     higher_member_id_assigned_ = true;
     process_member_info_response_<member_info_synch_response_message>(_rcvd_member_info_synch_response_message, _remote_endpoint);
     if (all_successors_known() && !synch_finished_ && synch_token_rcvd_) {
@@ -219,34 +249,37 @@ void str_dh::process_member_info_synch_response(member_info_synch_response_messa
     }
 }
 
-template<typename T, typename R> void str_dh::process_member_info_request_(T _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+template<typename T, typename R> void str_dh<group_t>::process_member_info_request_(const T& _rcvd_member_info_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (is_assigned() && !response_scheduled_ && _rcvd_member_info_request_message.required_service_ == service_of_interest_
-        && std::find(_rcvd_member_info_request_message.requested_members_.begin(), _rcvd_member_info_request_message.requested_members_.end(), member_id_) != _rcvd_member_info_request_message.requested_members_.end()) {
+        && _rcvd_member_info_request_message.requested_members_.contains(member_id_)) {
         response_scheduled_ = !response_scheduled_;
         scatter_timer_.expires_from_now(scatter_delay_);
         scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
             if (!_error) {
-                std::unique_ptr<R> member_info_resp_msg = std::make_unique<R>();
-                member_info_resp_msg->offered_service_ = service_of_interest_;
-                member_info_resp_msg->member_id_ = member_id_;
-                member_info_resp_msg->blinded_secret_ = blinded_secret_;
-                send(member_info_resp_msg.operator*()); statistics_recorder_->record_count(count_metric::MEMBER_INFO_RESPONSE_MESSAGE_COUNT_);
+                R member_info_resp_msg;
+                member_info_resp_msg.offered_service_ = service_of_interest_;
+                member_info_resp_msg.member_id_ = member_id_;
+                member_info_resp_msg.blinded_secret_ = wire_blinded_secret_;
+                send(member_info_resp_msg); statistics_recorder_->record_count(count_metric::MEMBER_INFO_RESPONSE_MESSAGE_COUNT_);
             }
             response_scheduled_ = !response_scheduled_;
         });
     }
 }
 
-template<typename T> void str_dh::process_member_info_response_(T _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+template<typename T> void str_dh<group_t>::process_member_info_response_(const T& _rcvd_member_info_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (!assigned_member_endpoint_map_[_rcvd_member_info_response_message.offered_service_].contains(_remote_endpoint)) {
-        assigned_member_key_map_[_rcvd_member_info_response_message.offered_service_][_rcvd_member_info_response_message.member_id_] = _rcvd_member_info_response_message.blinded_secret_;
+        assigned_member_key_map_[_rcvd_member_info_response_message.offered_service_][_rcvd_member_info_response_message.member_id_] = point_codec_.from_wire(_rcvd_member_info_response_message.blinded_secret_);
         assigned_member_endpoint_map_[_rcvd_member_info_response_message.offered_service_][_remote_endpoint] = _rcvd_member_info_response_message.member_id_;
         pending_requests_[_rcvd_member_info_response_message.offered_service_].erase(_remote_endpoint);
         check_and_add_next_blinded_key_to_group_secret();
     }
 }
 
-void str_dh::process_finish(finish_message _rcvd_finish_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (member_id_ == INITIAL_SPONSOR_ID && !finish_message_rcvd_) {
         statistics_recorder_->record_timestamp(time_metric::DURATION_END_);
     }
@@ -259,8 +292,8 @@ void str_dh::process_finish(finish_message _rcvd_finish_message, boost::asio::ip
     }
 
     if (member_id_ == INITIAL_SPONSOR_ID && assigned_member_endpoint_map_[service_of_interest_].count(_remote_endpoint) && assigned_member_endpoint_map_[service_of_interest_][_remote_endpoint] == member_count_) {
-        std::unique_ptr<finish_ack_message> finish_ack = std::make_unique<finish_ack_message>();
-        send(finish_ack.operator*()); statistics_recorder_->record_count(count_metric::FINISH_ACK_MESSAGE_COUNT_);
+        finish_ack_message finish_ack;
+        send(finish_ack); statistics_recorder_->record_count(count_metric::FINISH_ACK_MESSAGE_COUNT_);
         timeout_timer_.expires_from_now(std::chrono::seconds(TIMEOUT));
         timeout_timer_.async_wait([this](const boost::system::error_code& _error) {
             if (!_error) {
@@ -269,33 +302,34 @@ void str_dh::process_finish(finish_message _rcvd_finish_message, boost::asio::ip
             }
         });
 
-        std::unique_ptr<finish_message> finish = std::make_unique<finish_message>();
-        send(finish.operator*()); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+        finish_message finish;
+        send(finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
         scatter_timer_.expires_from_now(std::chrono::milliseconds(scatter_delay_));
         scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
             if (!_error) {
-                std::unique_ptr<finish_message> cyclic_finish = std::make_unique<finish_message>();
-                send(cyclic_finish.operator*()); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
-                std::unique_ptr<finish_message> self_finish = std::make_unique<finish_message>();
-                process_finish(self_finish.operator*(), get_local_endpoint());
+                finish_message cyclic_finish;
+                send(cyclic_finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+                finish_message self_finish;
+                process_finish(self_finish, get_local_endpoint());
             }
         });
     } else if (member_id_ == INITIAL_SPONSOR_ID && _remote_endpoint == get_local_endpoint()) {
-        std::unique_ptr<finish_message> finish = std::make_unique<finish_message>();
-        send(finish.operator*()); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+        finish_message finish;
+        send(finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
         scatter_timer_.expires_from_now(std::chrono::milliseconds(scatter_delay_));
         scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
             if (!_error) {
-                std::unique_ptr<finish_message> cyclic_finish = std::make_unique<finish_message>();
-                send(cyclic_finish.operator*()); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
-                std::unique_ptr<finish_message> self_finish = std::make_unique<finish_message>();
-                process_finish(self_finish.operator*(), get_local_endpoint());
+                finish_message cyclic_finish;
+                send(cyclic_finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+                finish_message self_finish;
+                process_finish(self_finish, get_local_endpoint());
             }
         });
     }
 }
 
-void str_dh::process_finish_ack(finish_ack_message _rcvd_finish_ack_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     higher_member_id_assigned_ = true;
     higher_member_id_synching_ = true;
     if (member_id_ != INITIAL_SPONSOR_ID) {
@@ -304,7 +338,8 @@ void str_dh::process_finish_ack(finish_ack_message _rcvd_finish_ack_message, boo
     }
 }
 
-void str_dh::process_pending_request() {
+template <typename group_t>
+void str_dh<group_t>::process_pending_request() {
     if (!is_sponsor_) {
         return;
     }
@@ -318,10 +353,10 @@ void str_dh::process_pending_request() {
 #endif
 
     std::pair<boost::asio::ip::udp::endpoint, blinded_secret_t> unassigned_member = get_unassigned_member();
-    boost::asio::ip::udp::endpoint pending_remote_endpoint = unassigned_member.first;
-    blinded_secret_t pending_blinded_secret = unassigned_member.second;
+    const boost::asio::ip::udp::endpoint& pending_remote_endpoint = unassigned_member.first;
+    const blinded_secret_t& pending_blinded_secret = unassigned_member.second;
 
-    if (pending_remote_endpoint.address().to_string().compare(UNINITIALIZED_ADDRESS) != 0 && pending_blinded_secret.SizeInBytes() != 0) {
+    if (!pending_remote_endpoint.address().is_unspecified() && pending_blinded_secret.SizeInBytes() != 0) {
         std::unique_ptr<str_key_tree> previous_str_tree = std::move(str_key_tree_map_[service_of_interest_]);
         secret_t group_secret(diffie_hellman_.AgreedValueLength());
         diffie_hellman_.Agree(group_secret, previous_str_tree->root_node_.group_secret_, pending_blinded_secret); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
@@ -331,48 +366,48 @@ void str_dh::process_pending_request() {
                                                                 pending_blinded_secret);
 
         is_sponsor_ = false;
-        std::unique_ptr<response_message> response = std::make_unique<response_message>();
-        response->blinded_group_secret_ = previous_str_tree->root_node_.blinded_group_secret_;
-        response->blinded_sponsor_secret_ = blinded_secret_;
-        response->new_sponsor.assigned_id_ = member_id_+1;
-        response->new_sponsor.ip_address_ = pending_remote_endpoint.address();
-        response->new_sponsor.port_ = pending_remote_endpoint.port();
-        response->new_sponsor.blinded_secret_ = pending_blinded_secret;
-        response->offered_service_ = service_of_interest_;
-        response_message_cache_ = std::make_unique<response_message>(response.operator*());
+        response_message response;
+        response.blinded_group_secret_ = point_codec_.to_wire(previous_str_tree->root_node_.blinded_group_secret_);
+        response.blinded_sponsor_secret_ = wire_blinded_secret_;
+        response.new_sponsor.assigned_id_ = member_id_+1;
+        response.new_sponsor.endpoint_ = pending_remote_endpoint;
+        response.new_sponsor.blinded_secret_ = point_codec_.to_wire(pending_blinded_secret);
+        response.offered_service_ = service_of_interest_;
+        response_cache_ = serialize(response);
 
         str_tree->next_internal_node_ = std::move(previous_str_tree);
         str_key_tree_map_[service_of_interest_] = std::move(str_tree);
 
-        assigned_member_key_map_[service_of_interest_][response->new_sponsor.assigned_id_] = pending_blinded_secret;
-        assigned_member_endpoint_map_[service_of_interest_][pending_remote_endpoint] = response->new_sponsor.assigned_id_;
+        assigned_member_key_map_[service_of_interest_][response.new_sponsor.assigned_id_] = pending_blinded_secret;
+        assigned_member_endpoint_map_[service_of_interest_][pending_remote_endpoint] = response.new_sponsor.assigned_id_;
         keys_computed_count_++;
 
-        send(response.operator*()); statistics_recorder_->record_count(count_metric::RESPONSE_MESSAGE_COUNT_);
+        send(response_cache_); statistics_recorder_->record_count(count_metric::RESPONSE_MESSAGE_COUNT_);
 #ifdef RETRANSMISSIONS
         send_cyclic_response();
 #endif
     } else {
 #ifdef RETRANSMISSIONS
-        std::unique_ptr<offer_message> offer = std::make_unique<offer_message>();
-        offer->offered_service_ = service_of_interest_;
-        send(offer.operator*()); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+        offer_message offer;
+        offer.offered_service_ = service_of_interest_;
+        send(offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
         send_cyclic_offer();
 #endif
     }
 }
 
-void str_dh::check_and_add_next_blinded_key_to_group_secret() {
+template <typename group_t>
+void str_dh<group_t>::check_and_add_next_blinded_key_to_group_secret() {
     if (!is_sponsor_ && is_assigned()) {
-        blinded_secret_t next_blinded_key;
-        while ((next_blinded_key = get_next_blinded_key()).SizeInBytes() != 0) {
-            secret_t old_group_secret = str_key_tree_map_[service_of_interest_]->root_node_.group_secret_;
+        const blinded_secret_t* next_blinded_key;
+        while ((next_blinded_key = get_next_blinded_key()) != nullptr && next_blinded_key->SizeInBytes() != 0) {
+            const secret_t& old_group_secret = str_key_tree_map_[service_of_interest_]->root_node_.group_secret_;
             secret_t new_group_secret(diffie_hellman_.AgreedValueLength());
-            diffie_hellman_.Agree(new_group_secret, old_group_secret, next_blinded_key); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+            diffie_hellman_.Agree(new_group_secret, old_group_secret, *next_blinded_key); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
             std::unique_ptr<str_key_tree> str_tree = build_str_tree(new_group_secret,
                                                                     DEFAULT_SECRET,
                                                                     DEFAULT_SECRET,
-                                                                    next_blinded_key);
+                                                                    *next_blinded_key);
             std::unique_ptr<str_key_tree> previous_str_tree = std::move(str_key_tree_map_[service_of_interest_]);
             str_tree->next_internal_node_ = std::move(previous_str_tree);
             str_key_tree_map_[service_of_interest_] = std::move(str_tree);
@@ -381,13 +416,14 @@ void str_dh::check_and_add_next_blinded_key_to_group_secret() {
     }
 }
 
-std::pair<boost::asio::ip::udp::endpoint, blinded_secret_t> str_dh::get_unassigned_member() {
+template <typename group_t>
+std::pair<boost::asio::ip::udp::endpoint, blinded_secret_t> str_dh<group_t>::get_unassigned_member() {
     std::pair<boost::asio::ip::udp::endpoint, blinded_secret_t> unassigned_member;
-    for (auto member : pending_requests_[service_of_interest_]) {
-        boost::asio::ip::udp::endpoint member_endpoint = member.first;
-        blinded_secret_t member_blinded_secret = member.second;
-        if (!assigned_member_endpoint_map_[service_of_interest_].contains(member_endpoint)) {
-            unassigned_member = std::make_pair(member_endpoint, member_blinded_secret);
+    for (auto& member : pending_requests_[service_of_interest_]) {
+        if (!assigned_member_endpoint_map_[service_of_interest_].contains(member.first)) {
+            // The pending requests are cleared below, so the blinded secret is taken over instead of copied
+            unassigned_member.first = member.first;
+            unassigned_member.second.swap(member.second);
             break;
         }
     }
@@ -395,16 +431,16 @@ std::pair<boost::asio::ip::udp::endpoint, blinded_secret_t> str_dh::get_unassign
     return unassigned_member;
 }
 
-blinded_secret_t str_dh::get_next_blinded_key() {
-    blinded_secret_t blinded_key;
-    if (assigned_member_key_map_[service_of_interest_].contains(keys_computed_count_ + member_id_)) {
-        blinded_key = assigned_member_key_map_[service_of_interest_][keys_computed_count_ + member_id_];
-    }
-    return blinded_key;  
+template <typename group_t>
+const blinded_secret_t* str_dh<group_t>::get_next_blinded_key() {
+    std::unordered_map<member_id_t, blinded_secret_t>& member_keys = assigned_member_key_map_[service_of_interest_];
+    auto next_member_key = member_keys.find(keys_computed_count_ + member_id_);
+    return next_member_key != member_keys.end() ? &next_member_key->second : nullptr;
 }
 
-std::unique_ptr<str_key_tree> str_dh::build_str_tree(secret_t _group_secret, blinded_secret_t _blinded_group_secret,
-                                            secret_t _member_secret, blinded_secret_t _blinded_member_secret) {
+template <typename group_t>
+std::unique_ptr<str_key_tree> str_dh<group_t>::build_str_tree(const secret_t& _group_secret, const blinded_secret_t& _blinded_group_secret,
+                                            const secret_t& _member_secret, const blinded_secret_t& _blinded_member_secret) {
     std::unique_ptr<str_key_tree> str_tree = std::make_unique<str_key_tree>();
     str_tree->root_node_.group_secret_ = _group_secret;
     str_tree->root_node_.blinded_group_secret_ = _blinded_group_secret;
@@ -413,36 +449,52 @@ std::unique_ptr<str_key_tree> str_dh::build_str_tree(secret_t _group_secret, bli
     return std::move(str_tree);
 }
 
-void str_dh::send(message& _message) {
-    boost::asio::streambuf buffer;
-    message_handler_->serialize(_message, buffer);
+template <typename group_t>
+void str_dh<group_t>::send(const message& _message) {
+    std::shared_ptr<std::vector<unsigned char>> buffer = acquire_send_buffer();
+    message_handler_->serialize(_message, *buffer);
     multicast_application_impl::send_multicast(buffer);
 }
 
-void str_dh::send_cyclic_offer() {
+template <typename group_t>
+void str_dh<group_t>::send(shared_datagram_t _datagram) {
+    multicast_application_impl::send_multicast(_datagram);
+}
+
+template <typename group_t>
+shared_datagram_t str_dh<group_t>::serialize(const message& _message) {
+    // The datagram is cached for retransmissions, so the buffer does not come from the send buffer pool
+    std::shared_ptr<std::vector<unsigned char>> buffer = std::make_shared<std::vector<unsigned char>>();
+    message_handler_->serialize(_message, *buffer);
+    return buffer;
+}
+
+template <typename group_t>
+void str_dh<group_t>::send_cyclic_offer() {
     scatter_timer_.expires_from_now(scatter_delay_);
     scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
         if (!_error && is_sponsor_ && assigned_member_key_map_[service_of_interest_].size() < member_id_) {
-            std::unique_ptr<offer_message> offer = std::make_unique<offer_message>();
-            offer->offered_service_ = service_of_interest_;
-            send(offer.operator*()); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+            offer_message offer;
+            offer.offered_service_ = service_of_interest_;
+            send(offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
             send_cyclic_offer();
         }
     });
 }
 
-void str_dh::send_cyclic_response() {
+template <typename group_t>
+void str_dh<group_t>::send_cyclic_response() {
     scatter_timer_.expires_from_now(scatter_delay_);
     scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
         if (!_error && assigned_member_key_map_[service_of_interest_].size() <= member_id_ && !higher_member_id_assigned_) {
-            std::unique_ptr<response_message> response = std::make_unique<response_message>(response_message_cache_.operator*());
-            send(response.operator*()); statistics_recorder_->record_count(count_metric::RESPONSE_MESSAGE_COUNT_);
+            send(response_cache_); statistics_recorder_->record_count(count_metric::RESPONSE_MESSAGE_COUNT_);
             send_cyclic_response();
         }
     });
 }
 
-void str_dh::send_cyclic_member_info_request_predecessors() {
+template <typename group_t>
+void str_dh<group_t>::send_cyclic_member_info_request_predecessors() {
     scatter_timer_.expires_from_now(scatter_delay_);
     scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
         if (!_error && !all_predecessors_known()) {
@@ -452,14 +504,17 @@ void str_dh::send_cyclic_member_info_request_predecessors() {
     });
 }
 
-void str_dh::send_member_info_request_predecessors() {
-    std::unique_ptr<member_info_request_message> member_info_req_msg = std::make_unique<member_info_request_message>();
-    member_info_req_msg->required_service_ = service_of_interest_;
-    member_info_req_msg->requested_members_ = get_unknown_predecessors();
-    send(member_info_req_msg.operator*()); statistics_recorder_->record_count(count_metric::MEMBER_INFO_REQUEST_MESSAGE_COUNT_);
+template <typename group_t>
+void str_dh<group_t>::send_member_info_request_predecessors() {
+    member_info_request_message member_info_req_msg;
+    wire_bitmap<member_id_t> unknown_predecessors = get_unknown_predecessors();
+    member_info_req_msg.required_service_ = service_of_interest_;
+    member_info_req_msg.requested_members_ = unknown_predecessors;
+    send(member_info_req_msg); statistics_recorder_->record_count(count_metric::MEMBER_INFO_REQUEST_MESSAGE_COUNT_);
 }
 
-void str_dh::send_cyclic_member_info_synch_request_successors() {
+template <typename group_t>
+void str_dh<group_t>::send_cyclic_member_info_synch_request_successors() {
     scatter_timer_.expires_from_now(scatter_delay_);
     scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
         if (!_error && !all_successors_known()) {
@@ -469,14 +524,17 @@ void str_dh::send_cyclic_member_info_synch_request_successors() {
     });
 }
 
-void str_dh::send_member_info_synch_request_successors() {
-    std::unique_ptr<member_info_synch_request_message> member_info_synch_req_msg = std::make_unique<member_info_synch_request_message>();
-    member_info_synch_req_msg->required_service_ = service_of_interest_;
-    member_info_synch_req_msg->requested_members_ = get_unknown_successors();
-    send(member_info_synch_req_msg.operator*()); statistics_recorder_->record_count(count_metric::MEMBER_INFO_REQUEST_MESSAGE_COUNT_);
+template <typename group_t>
+void str_dh<group_t>::send_member_info_synch_request_successors() {
+    member_info_synch_request_message member_info_synch_req_msg;
+    wire_bitmap<member_id_t> unknown_successors = get_unknown_successors();
+    member_info_synch_req_msg.required_service_ = service_of_interest_;
+    member_info_synch_req_msg.requested_members_ = unknown_successors;
+    send(member_info_synch_req_msg); statistics_recorder_->record_count(count_metric::MEMBER_INFO_REQUEST_MESSAGE_COUNT_);
 }
 
-void str_dh::send_cyclic_synch_token() {
+template <typename group_t>
+void str_dh<group_t>::send_cyclic_synch_token() {
     scatter_timer_.expires_from_now(scatter_delay_);
     scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
         if (!_error && !higher_member_id_synching_) {
@@ -486,13 +544,15 @@ void str_dh::send_cyclic_synch_token() {
     });
 }
 
-void str_dh::send_synch_token_to_next_member() {
-    std::unique_ptr<synch_token_message> synch_token_msg = std::make_unique<synch_token_message>();
-    synch_token_msg->member_id_ = member_id_ != member_count_ ? member_id_ + 1 : 1;
-    send(synch_token_msg.operator*()); statistics_recorder_->record_count(count_metric::SYNCH_TOKEN_MESSAGE_COUNT_);
+template <typename group_t>
+void str_dh<group_t>::send_synch_token_to_next_member() {
+    synch_token_message synch_token_msg;
+    synch_token_msg.member_id_ = member_id_ != member_count_ ? member_id_ + 1 : 1;
+    send(synch_token_msg); statistics_recorder_->record_count(count_metric::SYNCH_TOKEN_MESSAGE_COUNT_);
 }
 
-void str_dh::send_cyclic_finish() {
+template <typename group_t>
+void str_dh<group_t>::send_cyclic_finish() {
     scatter_timer_.expires_from_now(scatter_delay_);
     scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
         if (!_error) {
@@ -502,54 +562,56 @@ void str_dh::send_cyclic_finish() {
     });
 }
 
-void str_dh::send_finish() {
-    std::unique_ptr<finish_message> finish = std::make_unique<finish_message>();
-    send(finish.operator*()); statistics_recorder_->record_count(count_metric::FINISH_MESSAGE_COUNT_);
+template <typename group_t>
+void str_dh<group_t>::send_finish() {
+    finish_message finish;
+    send(finish); statistics_recorder_->record_count(count_metric::FINISH_MESSAGE_COUNT_);
 }
 
-bool str_dh::is_assigned() {
+template <typename group_t>
+bool str_dh<group_t>::is_assigned() {
     return member_id_ != DEFAULT_MEMBER_ID;
 }
 
-bool str_dh::is_last_member() {
+template <typename group_t>
+bool str_dh<group_t>::is_last_member() {
     return is_assigned() && (member_id_ == member_count_);
 }
 
-bool str_dh::all_predecessors_known() {
+template <typename group_t>
+bool str_dh<group_t>::all_predecessors_known() {
     return assigned_member_endpoint_map_[service_of_interest_].size() >= member_id_-is_assigned();
 }
 
-bool str_dh::all_successors_known() {
+template <typename group_t>
+bool str_dh<group_t>::all_successors_known() {
     return assigned_member_endpoint_map_[service_of_interest_].size() == member_count_-is_assigned();
 }
 
-std::vector<member_id_t> str_dh::get_unknown_predecessors() {
-    std::vector<member_id_t> unknown_predecessors;
+template <typename group_t>
+wire_bitmap<member_id_t> str_dh<group_t>::get_unknown_predecessors() {
+    wire_bitmap<member_id_t> unknown_predecessors;
     for (member_id_t i = 1; i < member_id_; i++) {
         if (!assigned_member_key_map_[service_of_interest_].contains(i)) {
-            unknown_predecessors.push_back(i);
+            unknown_predecessors.insert(i);
         }
-        // if (unknown_predecessors.size() >= 100) { // Lists can get bigger than buffers causing input stream errors! Asking for a x of members at a time limits the maximum for each request
-        //     break;
-        // }
     }
     return unknown_predecessors;
 }
 
-std::vector<member_id_t> str_dh::get_unknown_successors() {
-    std::vector<member_id_t> unknown_successors;
+template <typename group_t>
+wire_bitmap<member_id_t> str_dh<group_t>::get_unknown_successors() {
+    wire_bitmap<member_id_t> unknown_successors;
     for (member_id_t i = member_id_+1; i <= member_count_; i++) {
         if (!assigned_member_key_map_[service_of_interest_].contains(i)) {
-            unknown_successors.push_back(i);
+            unknown_successors.insert(i);
         }
-        // if (unknown_successors.size() >= 100) { // Lists can get bigger than buffers causing input stream errors! Asking for a x of members at a time limits the maximum for each request
-        //     break;
-        // }
     }
     return unknown_successors;
 }
 
-void str_dh::check_if_higher_member_id_assigned(boost::asio::ip::udp::endpoint _remote_endpoint) {
+template <typename group_t>
+void str_dh<group_t>::check_if_higher_member_id_assigned(const boost::asio::ip::udp::endpoint& _remote_endpoint) {
     if (is_assigned() && !higher_member_id_assigned_ && 
         (assigned_member_endpoint_map_[service_of_interest_].count(_remote_endpoint) && assigned_member_endpoint_map_[service_of_interest_][_remote_endpoint] > (member_id_ % member_count_)
         || !assigned_member_endpoint_map_[service_of_interest_].count(_remote_endpoint))) {
@@ -557,7 +619,8 @@ void str_dh::check_if_higher_member_id_assigned(boost::asio::ip::udp::endpoint _
     }   
 }
 
-std::string str_dh::short_secret_repr(secret_t _secret) {
+template <typename group_t>
+std::string str_dh<group_t>::short_secret_repr(const secret_t& _secret) {
     CryptoPP::Integer secret_int;
     secret_int.Decode(_secret.BytePtr(), _secret.SizeInBytes());
     std::stringstream ss;
@@ -568,18 +631,29 @@ std::string str_dh::short_secret_repr(secret_t _secret) {
     return ss.str();
 }
 
-void str_dh::contribute_statistics() {
+template <typename group_t>
+void str_dh<group_t>::contribute_statistics() {
     if((assigned_member_endpoint_map_[service_of_interest_].size()+is_assigned() == member_count_) && (member_count_ - member_id_ + 1 == keys_computed_count_)
         && (assigned_member_key_map_[service_of_interest_].size() == assigned_member_endpoint_map_[service_of_interest_].size())) {
 #ifndef RETRANSMISSIONS
             statistics_recorder_->record_timestamp(time_metric::DURATION_END_);
 #endif
+            record_transport_statistics();
             statistics_recorder_->contribute_statistics();
             multicast_application_impl::stop();
     }
 }
 
-std::chrono::milliseconds str_dh::compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max) {
+template <typename group_t>
+void str_dh<group_t>::record_transport_statistics() {
+    transport_statistics statistics = multicast_application_impl::get_transport_statistics();
+    statistics_recorder_->record_count(count_metric::KERNEL_DROP_COUNT_, statistics.kernel_drops_);
+    statistics_recorder_->record_maximum(count_metric::RECEIVE_QUEUE_HIGH_WATER_MARK_, statistics.receive_queue_high_water_mark_);
+    statistics_recorder_->record_maximum(count_metric::SEND_QUEUE_HIGH_WATER_MARK_, statistics.send_queue_high_water_mark_);
+}
+
+template <typename group_t>
+std::chrono::milliseconds str_dh<group_t>::compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max) {
     if (_scatter_delay_min > _scatter_delay_max) {
         const std::uint32_t tmp(_scatter_delay_min);
         _scatter_delay_min = _scatter_delay_max;
@@ -592,10 +666,11 @@ std::chrono::milliseconds str_dh::compute_scatter_delay(std::uint32_t _scatter_d
     return std::chrono::milliseconds(distribution(mersenne_twister));
 }
 
-void str_dh::start() {
+template <typename group_t>
+void str_dh<group_t>::start() {
     multicast_application_impl::start();
 }
 
-void str_dh::process_distributed_response(distributed_response_message _rcvd_distributed_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) {
-    // Unused, just here to comply with key_agreement_protocol
-}
\ No newline at end of file
+template class str_dh<default_dh_group>;
+template class str_dh<ecc_dh_group>;
+template class str_dh<x25519_dh_group>;
@@ -4,12 +4,13 @@
 #include "key_agreement_protocol.hpp"
 #include "str_key_tree.hpp"
 #include "primitives.hpp"
+#include "point_codec.hpp"
+#include "crypto_groups.hpp"
+#include "key_pair_pool.hpp"
 #include "message_handler.hpp"
 #include "multicast_application_impl.hpp"
 #include "statistics_recorder.hpp"
 
-#include <cryptopp/dh.h>
-#include <cryptopp/eccrypto.h>
 #include <cryptopp/osrng.h>
 #include <unordered_map>
 #include <set>
@@ -17,17 +18,18 @@
 
 #define INITIAL_SPONSOR_ID 1
 
+// Instantiated with the crypto group policies of crypto_groups.hpp in str_dh.cpp
+template <typename group_t>
 class str_dh : public key_agreement_protocol, public multicast_application_impl {
     // Variables
     public:
+        // Dispatched by message_handler, all other message types are dropped before decoding
+        typedef handled_messages<find_message, offer_message, request_message, response_message, member_info_request_message,
+                                 member_info_response_message, synch_token_message, member_info_synch_request_message,
+                                 member_info_synch_response_message, finish_message, finish_ack_message> handled_messages_t;
     protected:
     private:
-#ifdef DEFAULT_DH
-        CryptoPP::DH diffie_hellman_;
-#elif defined(ECC_DH)
-        CryptoPP::ECDH<CryptoPP::ECP>::Domain diffie_hellman_;
-#endif
-        std::mutex receive_mutex_;
+        typename group_t::domain_t diffie_hellman_;
         service_id_t service_of_interest_ = DEFAULT_SERVICE_ID;
         member_id_t member_id_ = DEFAULT_MEMBER_ID;
         bool is_sponsor_;
@@ -43,45 +45,51 @@ class str_dh : public key_agreement_protocol, public multicast_application_impl
         CryptoPP::AutoSeededRandomPool rng_;
         secret_t secret_;
         blinded_secret_t blinded_secret_;
+        point_codec<typename group_t::domain_t> point_codec_;
+        // blinded_secret_ as sent on the wire
+        byte_view_t wire_blinded_secret_;
         std::unordered_map<service_id_t, std::unique_ptr<str_key_tree>> str_key_tree_map_;
         std::unordered_map<service_id_t, std::unordered_map<boost::asio::ip::udp::endpoint, blinded_secret_t>> pending_requests_;
         std::unordered_map<service_id_t, std::unordered_map<member_id_t,blinded_secret_t>> assigned_member_key_map_;
         std::unordered_map<service_id_t, std::unordered_map<boost::asio::ip::udp::endpoint,member_id_t>> assigned_member_endpoint_map_;
-        std::unique_ptr<message_handler> message_handler_;
+        std::unique_ptr<message_handler<str_dh>> message_handler_;
         std::uint32_t member_count_;
         std::unique_ptr<statistics_recorder> statistics_recorder_;
         std::chrono::milliseconds scatter_delay_;
         boost::asio::steady_timer scatter_timer_;
         boost::asio::steady_timer timeout_timer_;
-        std::unique_ptr<response_message> response_message_cache_;
+        // Serialized once, retransmissions resend the same bytes
+        shared_datagram_t response_cache_;
     // Methods
     public:
-        str_dh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port);
+        str_dh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count = 1, std::uint32_t _send_rate = 0, in_memory_bus* _in_memory_bus = nullptr);
         ~str_dh();
         void start();
         virtual void received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_find(find_message _rcvd_find_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_offer(offer_message _rcvd_offer_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_request(request_message _rcvd_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_response(response_message _rcvd_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_request(member_info_request_message _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_response(member_info_response_message _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_synch_token(synch_token_message _rcvd_synch_token_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_synch_request(member_info_synch_request_message _rcvd_member_info_synch_request_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_member_info_synch_response(member_info_synch_response_message _rcvd_member_info_synch_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_distributed_response(distributed_response_message _rcvd_distributed_response_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_finish(finish_message _rcvd_finish_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
-        virtual void process_finish_ack(finish_ack_message _rcvd_finish_ack_message, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+        void process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_response(const response_message& _rcvd_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_member_info_request(const member_info_request_message& _rcvd_member_info_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_member_info_response(const member_info_response_message& _rcvd_member_info_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_synch_token(const synch_token_message& _rcvd_synch_token_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_member_info_synch_request(const member_info_synch_request_message& _rcvd_member_info_synch_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_member_info_synch_response(const member_info_synch_response_message& _rcvd_member_info_synch_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        bool is_relevant(const message_header& _header);
     protected:
     private:
         void process_pending_request();
         void check_and_add_next_blinded_key_to_group_secret();
-        blinded_secret_t get_next_blinded_key();
+        const blinded_secret_t* get_next_blinded_key();
         std::pair<boost::asio::ip::udp::endpoint, blinded_secret_t> get_unassigned_member();
-        std::unique_ptr<str_key_tree> build_str_tree(secret_t _group_secret, blinded_secret_t _blinded_group_secret,
-                                                 secret_t _member_secret, blinded_secret_t _blinded_member_secret);
-        void check_if_higher_member_id_assigned(boost::asio::ip::udp::endpoint _remote_endpoint);
-        void send(message& _message);
+        std::unique_ptr<str_key_tree> build_str_tree(const secret_t& _group_secret, const blinded_secret_t& _blinded_group_secret,
+                                                 const secret_t& _member_secret, const blinded_secret_t& _blinded_member_secret);
+        void check_if_higher_member_id_assigned(const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void send(const message& _message);
+        void send(shared_datagram_t _datagram);
+        shared_datagram_t serialize(const message& _message);
         void send_cyclic_offer();
         void send_cyclic_response();
         void send_cyclic_member_info_request_predecessors();
@@ -96,13 +104,14 @@ class str_dh : public key_agreement_protocol, public multicast_application_impl
         bool is_last_member();
         bool all_predecessors_known();
         bool all_successors_known();
-        std::vector<member_id_t> get_unknown_predecessors();
-        std::vector<member_id_t> get_unknown_successors();
-        std::string short_secret_repr(secret_t _secret);
+        wire_bitmap<member_id_t> get_unknown_predecessors();
+        wire_bitmap<member_id_t> get_unknown_successors();
+        std::string short_secret_repr(const secret_t& _secret);
         void contribute_statistics();
+        void record_transport_statistics();
         std::chrono::milliseconds compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max);
-        template <typename T, typename R> void process_member_info_request_(T _rcvd_member_info_request_message, boost::asio::ip::udp::endpoint _remote_endpoint);
-        template <typename T> void process_member_info_response_(T _rcvd_member_info_response_message, boost::asio::ip::udp::endpoint _remote_endpoint);
+        template <typename T, typename R> void process_member_info_request_(const T& _rcvd_member_info_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        template <typename T> void process_member_info_response_(const T& _rcvd_member_info_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,430 @@
+#include "tgdh.hpp"
+
+#include <unistd.h>
+#include <random>
+#include <sstream>
+#include <cryptopp/nbtheory.h>
+#include <cryptopp/oids.h>
+#include <cryptopp/asn.h>
+
+template <typename group_t>
+tgdh<group_t>::tgdh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count, std::uint32_t _send_rate, in_memory_bus* _in_memory_bus) : is_sponsor_(_is_sponsor), request_scheduled_(false), finish_message_rcvd_(false), next_member_id_(INITIAL_SPONSOR_ID + 1), service_of_interest_(_service_id), member_count_(_member_count), multicast_application_impl(_listening_interface_by_ip, _multicast_ip, _multicast_port, _worker_thread_count, _send_rate, _in_memory_bus), message_handler_(std::make_unique<message_handler<tgdh>>(this)), statistics_recorder_(_in_memory_bus ? statistics_recorder::create_instance() : statistics_recorder::get_instance()), scatter_timer_(multicast_application_impl::get_strand()), timeout_timer_(multicast_application_impl::get_strand()) {
+    if (is_sponsor_) {
+        statistics_recorder_->record_timestamp(time_metric::DURATION_START_);
+    }
+#ifdef RETRANSMISSIONS
+    scatter_delay_ = compute_scatter_delay(_scatter_delay_min, _scatter_delay_max);
+#endif
+    group_t::initialize(diffie_hellman_);
+    point_codec_.initialize(diffie_hellman_);
+    LOG_DEBUG("[<tgdh>]: Using " << group_t::name_)
+    // Members of an in-memory simulation pull key pairs that were generated in the background while the members before them were constructed
+    key_pair_pool<typename group_t::domain_t>* pregenerated_key_pairs = _in_memory_bus ? key_pair_pool<typename group_t::domain_t>::get_instance(diffie_hellman_, member_count_, _worker_thread_count) : nullptr;
+    if (!pregenerated_key_pairs || !pregenerated_key_pairs->pull(secret_, blinded_secret_)) {
+        secret_.New(diffie_hellman_.PrivateKeyLength());
+        blinded_secret_.New(diffie_hellman_.PublicKeyLength());
+        diffie_hellman_.GeneratePrivateKey(rng_, secret_);
+        diffie_hellman_.GeneratePublicKey(rng_, secret_, blinded_secret_);
+    }
+    // Pulled pairs are counted as well, they were generated for this member
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+    wire_blinded_secret_ = point_codec_.to_wire(blinded_secret_);
+
+    blinded_keys_.clear();
+    responses_.clear();
+    endpoints_acks_rcvd_from_.clear();
+
+    statistics_recorder_->record_count(count_metric::MEMBER_COUNT_);
+    if (is_sponsor_) {
+        assign_member_id(INITIAL_SPONSOR_ID);
+        offer_message initial_offer;
+        initial_offer.offered_service_ = service_of_interest_;
+        send(initial_offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+#ifdef RETRANSMISSIONS
+        send_cyclic_messages();
+#endif
+    }
+}
+
+template <typename group_t>
+tgdh<group_t>::~tgdh() {
+
+}
+
+template <typename group_t>
+void tgdh<group_t>::start() {
+    multicast_application_impl::start();
+}
+
+template <typename group_t>
+void tgdh<group_t>::received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) {
+    // Runs on the strand, so no further locking of the protocol state is needed
+    if (get_local_endpoint().port() != _remote_endpoint.port()) {
+        message_handler_->deserialize_and_callback(byte_view_t(_data, _bytes_recvd), _remote_endpoint);
+    }
+}
+
+template <typename group_t>
+bool tgdh<group_t>::is_relevant(const message_header& _header) {
+    if (_header.service_id_ != ANY_SERVICE_ID && _header.service_id_ != service_of_interest_) {
+        return false;
+    }
+    switch (_header.message_type_) {
+        case message_type::REQUEST:
+        case message_type::FINISH_ACK:
+            // Only the initial sponsor assigns member ids and collects acknowledgements
+            return is_sponsor_;
+        case message_type::OFFER:
+            return !is_assigned();
+        case message_type::RESPONSE:
+        case message_type::BLINDED_KEY:
+            // Only carry blinded keys, which are not needed anymore once the group secret is computed
+            return !group_secret_computed();
+        default:
+            return true;
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (is_sponsor_ && service_of_interest_ == _rcvd_find_message.required_service_) {
+        offer_message offer;
+        offer.offered_service_ = service_of_interest_;
+        send(offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (!is_assigned() && _rcvd_offer_message.offered_service_ == service_of_interest_ && !request_scheduled_) {
+        sponsor_endpoint_ = _remote_endpoint;
+#ifdef RETRANSMISSIONS
+        request_scheduled_ = !request_scheduled_;
+        scatter_timer_.expires_from_now(scatter_delay_);
+        scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
+            if (!_error) {
+                request_message request;
+                request.blinded_secret_ = wire_blinded_secret_;
+                request.required_service_ = service_of_interest_;
+                send_to(request, sponsor_endpoint_); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
+            }
+            request_scheduled_ = !request_scheduled_;
+        });
+#else
+        request_message request;
+        request.blinded_secret_ = wire_blinded_secret_;
+        request.required_service_ = service_of_interest_;
+        send_to(request, sponsor_endpoint_); statistics_recorder_->record_count(count_metric::REQUEST_MESSAGE_COUNT_);
+#endif
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (_rcvd_request_message.required_service_ != service_of_interest_) {
+        return;
+    }
+    if (responses_.empty()) {
+        statistics_recorder_->record_timestamp(time_metric::KEY_AGREEMENT_START_);
+    }
+    // A repeated request means the response was lost
+    if (responses_.contains(_remote_endpoint)) {
+        send(responses_[_remote_endpoint]); statistics_recorder_->record_count(count_metric::RESPONSE_MESSAGE_COUNT_);
+        return;
+    }
+    // Checked before it is passed to Crypto++ as a raw pointer
+    blinded_secret_t blinded_member_secret = point_codec_.from_wire(_rcvd_request_message.blinded_secret_);
+    if (all_members_assigned() || blinded_member_secret.SizeInBytes() != diffie_hellman_.PublicKeyLength()) {
+        return;
+    }
+    member_id_t assigned_id = next_member_id_++;
+    blinded_keys_[tgdh_path(assigned_id, member_count_).front().node_id_] = blinded_member_secret;
+
+    // Every member learns the leaf blinded keys from the responses, the sponsor's leaf is sent along with each
+    response_message response;
+    response.offered_service_ = service_of_interest_;
+    response.blinded_sponsor_secret_ = wire_blinded_secret_;
+    response.new_sponsor.endpoint_ = _remote_endpoint;
+    response.new_sponsor.assigned_id_ = assigned_id;
+    response.new_sponsor.blinded_secret_ = _rcvd_request_message.blinded_secret_;
+    responses_[_remote_endpoint] = serialize(response);
+    send(responses_[_remote_endpoint]); statistics_recorder_->record_count(count_metric::RESPONSE_MESSAGE_COUNT_);
+    LOG_DEBUG("[<tgdh>]: pid=" << getpid() << " assigned member id " << assigned_id << " to " << _remote_endpoint)
+
+    compute_path_secrets();
+}
+
+template <typename group_t>
+void tgdh<group_t>::process_response(const response_message& _rcvd_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (_rcvd_response_message.offered_service_ != service_of_interest_ || _rcvd_response_message.new_sponsor.assigned_id_ <= INITIAL_SPONSOR_ID
+        || _rcvd_response_message.new_sponsor.assigned_id_ > member_count_) {
+        return;
+    }
+    sponsor_endpoint_ = _remote_endpoint;
+    store_blinded_key(tgdh_path(INITIAL_SPONSOR_ID, member_count_).front().node_id_, _rcvd_response_message.blinded_sponsor_secret_);
+    store_blinded_key(tgdh_path(_rcvd_response_message.new_sponsor.assigned_id_, member_count_).front().node_id_, _rcvd_response_message.new_sponsor.blinded_secret_);
+    if (!is_assigned() && _rcvd_response_message.new_sponsor.endpoint_ == get_local_endpoint()) {
+        assign_member_id(_rcvd_response_message.new_sponsor.assigned_id_);
+#ifdef RETRANSMISSIONS
+        send_cyclic_messages();
+#endif
+    }
+    compute_path_secrets();
+}
+
+template <typename group_t>
+void tgdh<group_t>::process_blinded_key(const blinded_key_message& _rcvd_blinded_key_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (_rcvd_blinded_key_message.offered_service_ == service_of_interest_) {
+        store_blinded_key(_rcvd_blinded_key_message.node_id_, _rcvd_blinded_key_message.blinded_key_);
+        compute_path_secrets();
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::assign_member_id(member_id_t _member_id) {
+    member_id_ = _member_id;
+    path_ = tgdh_path(member_id_, member_count_);
+    // Reserved up front, compute_path_secrets holds references into it while appending
+    path_secrets_.reserve(path_.size());
+    path_secrets_.push_back(secret_);
+#ifdef RETRANSMISSIONS
+    // The leaf blinded key was sent with the response already, it is only repeated for members that lost it
+    blinded_key_message leaf_blinded_key;
+    leaf_blinded_key.offered_service_ = service_of_interest_;
+    leaf_blinded_key.node_id_ = path_.front().node_id_;
+    leaf_blinded_key.blinded_key_ = wire_blinded_secret_;
+    sponsored_blinded_keys_.push_back(serialize(leaf_blinded_key));
+#endif
+    LOG_DEBUG("[<tgdh>]: pid=" << getpid() << " has member id " << member_id_ << " at depth " << path_.size()-1)
+}
+
+template <typename group_t>
+void tgdh<group_t>::store_blinded_key(node_id_t _node_id, byte_view_t _wire_blinded_key) {
+    if (blinded_keys_.contains(_node_id)) {
+        return;
+    }
+    // Checked before it is passed to Crypto++ as a raw pointer
+    blinded_secret_t blinded_key = point_codec_.from_wire(_wire_blinded_key);
+    if (blinded_key.SizeInBytes() == diffie_hellman_.PublicKeyLength()) {
+        blinded_keys_[_node_id] = blinded_key;
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::compute_path_secrets() {
+    if (!is_assigned() || group_secret_computed()) {
+#ifndef RETRANSMISSIONS
+        contribute_statistics();
+#endif
+        return;
+    }
+    // Climbs as far as the blinded keys of the siblings on the path are known, one key agreement per level
+    while (path_secrets_.size() < path_.size()) {
+        const tgdh_node& child = path_[path_secrets_.size()-1];
+        auto sibling_blinded_key = blinded_keys_.find(child.node_id_ ^ 1);
+        if (sibling_blinded_key == blinded_keys_.end()) {
+            return;
+        }
+        const secret_t& child_secret = path_secrets_.back();
+        secret_t parent_secret(diffie_hellman_.AgreedValueLength());
+        diffie_hellman_.Agree(parent_secret, child_secret, sibling_blinded_key->second); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+        path_secrets_.push_back(parent_secret);
+
+        const tgdh_node& parent = path_[path_secrets_.size()-1];
+        if (!parent.is_root() && parent.first_member_id_ == member_id_) {
+            blinded_secret_t blinded_key(diffie_hellman_.PublicKeyLength());
+            diffie_hellman_.GeneratePublicKey(rng_, path_secrets_.back(), blinded_key); statistics_recorder_->record_count(count_metric::CRYPTO_OPERATIONS_COUNT_);
+            send_blinded_key(parent.node_id_, blinded_key);
+        }
+    }
+    LOG_DEBUG("[<tgdh>]: pid=" << getpid() << " computed group secret " << short_secret_repr(path_secrets_.back()))
+#ifdef RETRANSMISSIONS
+    if (is_sponsor_) {
+        check_all_acks_rcvd();
+    } else {
+        finish_ack_message finish_ack;
+        send_to(finish_ack, sponsor_endpoint_); statistics_recorder_->record_count(count_metric::FINISH_ACK_MESSAGE_COUNT_);
+    }
+#else
+    contribute_statistics();
+#endif
+}
+
+template <typename group_t>
+void tgdh<group_t>::send_blinded_key(node_id_t _node_id, const blinded_secret_t& _blinded_key) {
+    blinded_key_message blinded_key;
+    blinded_key.offered_service_ = service_of_interest_;
+    blinded_key.node_id_ = _node_id;
+    blinded_key.blinded_key_ = point_codec_.to_wire(_blinded_key);
+    shared_datagram_t datagram = serialize(blinded_key);
+#ifdef RETRANSMISSIONS
+    sponsored_blinded_keys_.push_back(datagram);
+#endif
+    send(datagram); statistics_recorder_->record_count(count_metric::BLINDED_KEY_MESSAGE_COUNT_);
+}
+
+template <typename group_t>
+void tgdh<group_t>::check_all_acks_rcvd() {
+    if (is_sponsor_ && group_secret_computed() && endpoints_acks_rcvd_from_.size() == member_count_-1) {
+        is_sponsor_ = false;
+        statistics_recorder_->record_timestamp(time_metric::DURATION_END_);
+        timeout_timer_.expires_from_now(std::chrono::seconds(TIMEOUT));
+        timeout_timer_.async_wait([this](const boost::system::error_code& _error) {
+            if (!_error) {
+                scatter_timer_.cancel();
+                contribute_statistics();
+            }
+        });
+        finish_message finish;
+        send(finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+        finish_message self_msg;
+        process_finish(self_msg, get_local_endpoint());
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::send_cyclic_messages() {
+    scatter_timer_.expires_from_now(scatter_delay_);
+    scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
+        if (_error || finish_message_rcvd_) {
+            return;
+        }
+        // Members that lost their response keep requesting, so the sponsor offers until all members acknowledged
+        if (is_sponsor_ && endpoints_acks_rcvd_from_.size() != member_count_-1) {
+            offer_message offer;
+            offer.offered_service_ = service_of_interest_;
+            send(offer); statistics_recorder_->record_count(count_metric::OFFER_MESSAGE_COUNT_);
+        }
+        // Members further down in other subtrees may still miss a blinded key, so they are repeated until the finish
+        for (shared_datagram_t& datagram : sponsored_blinded_keys_) {
+            send(datagram); statistics_recorder_->record_count(count_metric::BLINDED_KEY_MESSAGE_COUNT_);
+        }
+        if (!is_sponsor_ && group_secret_computed()) {
+            finish_ack_message finish_ack;
+            send_to(finish_ack, sponsor_endpoint_); statistics_recorder_->record_count(count_metric::FINISH_ACK_MESSAGE_COUNT_);
+        }
+        send_cyclic_messages();
+    });
+}
+
+template <typename group_t>
+void tgdh<group_t>::process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (_remote_endpoint != get_local_endpoint()) {
+        finish_message_rcvd_ = true;
+        scatter_timer_.cancel();
+        contribute_statistics();
+    }
+    if (_remote_endpoint == get_local_endpoint()) {
+        scatter_timer_.expires_from_now(scatter_delay_);
+        scatter_timer_.async_wait([this](const boost::system::error_code& _error) {
+            if (!_error) {
+                finish_message finish;
+                send(finish); // Message is not counted, since its only for triggering other members to contribute statistics and shut down
+                finish_message self_msg;
+                process_finish(self_msg, get_local_endpoint());
+            }
+        });
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    if (responses_.contains(_remote_endpoint)) {
+        endpoints_acks_rcvd_from_.insert(_remote_endpoint);
+        check_all_acks_rcvd();
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::send(const message& _message) {
+    std::shared_ptr<std::vector<unsigned char>> buffer = acquire_send_buffer();
+    message_handler_->serialize(_message, *buffer);
+    multicast_application_impl::send_multicast(buffer);
+}
+
+template <typename group_t>
+void tgdh<group_t>::send(shared_datagram_t _datagram) {
+    multicast_application_impl::send_multicast(_datagram);
+}
+
+template <typename group_t>
+void tgdh<group_t>::send_to(const message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint) {
+    std::shared_ptr<std::vector<unsigned char>> buffer = acquire_send_buffer();
+    message_handler_->serialize(_message, *buffer);
+    multicast_application_impl::send_to(buffer, _remote_endpoint);
+}
+
+template <typename group_t>
+shared_datagram_t tgdh<group_t>::serialize(const message& _message) {
+    // Responses and sponsored blinded keys are cached for retransmissions, so the buffer does not come from the send buffer pool
+    std::shared_ptr<std::vector<unsigned char>> buffer = std::make_shared<std::vector<unsigned char>>();
+    message_handler_->serialize(_message, *buffer);
+    return buffer;
+}
+
+template <typename group_t>
+bool tgdh<group_t>::is_assigned() {
+    return member_id_ != DEFAULT_MEMBER_ID;
+}
+
+template <typename group_t>
+bool tgdh<group_t>::all_members_assigned() {
+    return next_member_id_ > member_count_;
+}
+
+template <typename group_t>
+bool tgdh<group_t>::group_secret_computed() {
+    return is_assigned() && path_secrets_.size() == path_.size();
+}
+
+template <typename group_t>
+std::string tgdh<group_t>::short_secret_repr(const secret_t& _secret) {
+    CryptoPP::Integer secret_int;
+    secret_int.Decode(_secret.BytePtr(), _secret.SizeInBytes());
+    std::stringstream ss;
+    ss << secret_int;
+    std::string secret_string = ss.str();
+    ss.str("");
+    ss << secret_string.substr(0,3) << "..." << secret_string.substr(secret_string.length()-4,3);
+    return ss.str();
+}
+
+template <typename group_t>
+void tgdh<group_t>::contribute_statistics() {
+    // Without retransmissions the initial sponsor stays until it answered every request
+    if (group_secret_computed() && (member_id_ != INITIAL_SPONSOR_ID || all_members_assigned())) {
+#ifndef RETRANSMISSIONS
+        statistics_recorder_->record_timestamp(time_metric::DURATION_END_);
+#endif
+        record_transport_statistics();
+        statistics_recorder_->contribute_statistics();
+        multicast_application_impl::stop();
+    }
+}
+
+template <typename group_t>
+void tgdh<group_t>::record_transport_statistics() {
+    transport_statistics statistics = multicast_application_impl::get_transport_statistics();
+    statistics_recorder_->record_count(count_metric::KERNEL_DROP_COUNT_, statistics.kernel_drops_);
+    statistics_recorder_->record_maximum(count_metric::RECEIVE_QUEUE_HIGH_WATER_MARK_, statistics.receive_queue_high_water_mark_);
+    statistics_recorder_->record_maximum(count_metric::SEND_QUEUE_HIGH_WATER_MARK_, statistics.send_queue_high_water_mark_);
+}
+
+template <typename group_t>
+std::chrono::milliseconds tgdh<group_t>::compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max) {
+    if (_scatter_delay_min > _scatter_delay_max) {
+        const std::uint32_t tmp(_scatter_delay_min);
+        _scatter_delay_min = _scatter_delay_max;
+        _scatter_delay_max = tmp;
+    }
+    std::random_device random_device;
+    std::mt19937 mersenne_twister(random_device());
+    std::uniform_int_distribution<std::uint32_t> distribution(
+            _scatter_delay_min, _scatter_delay_max);
+    return std::chrono::milliseconds(distribution(mersenne_twister));
+}
+
+template class tgdh<default_dh_group>;
+template class tgdh<ecc_dh_group>;
+template class tgdh<x25519_dh_group>;
@@ -0,0 +1,101 @@
+#ifndef TGDH
+#define TGDH
+
+#include "key_agreement_protocol.hpp"
+#include "tgdh_key_tree.hpp"
+#include "primitives.hpp"
+#include "point_codec.hpp"
+#include "crypto_groups.hpp"
+#include "key_pair_pool.hpp"
+#include "message_handler.hpp"
+#include "multicast_application_impl.hpp"
+#include "statistics_recorder.hpp"
+
+#include <cryptopp/osrng.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifndef INITIAL_SPONSOR_ID
+#define INITIAL_SPONSOR_ID 1
+#endif
+
+// Tree-based group Diffie-Hellman: the initial sponsor assigns the member ids, which place the members on the leaves of
+// a balanced binary key tree (tgdh_key_tree.hpp). Every member then computes the secrets from its leaf up to the root
+// with one key agreement per level, the root's secret is the group secret. Instantiated with the crypto group policies
+// of crypto_groups.hpp in tgdh.cpp
+template <typename group_t>
+class tgdh : public key_agreement_protocol, public multicast_application_impl {
+    // Variables
+    public:
+        // Dispatched by message_handler, all other message types are dropped before decoding
+        typedef handled_messages<find_message, offer_message, request_message, response_message, blinded_key_message,
+                                 finish_message, finish_ack_message> handled_messages_t;
+    protected:
+    private:
+        typename group_t::domain_t diffie_hellman_;
+        service_id_t service_of_interest_ = DEFAULT_SERVICE_ID;
+        member_id_t member_id_ = DEFAULT_MEMBER_ID;
+        bool is_sponsor_;
+        bool request_scheduled_;
+        bool finish_message_rcvd_;
+        CryptoPP::AutoSeededRandomPool rng_;
+        secret_t secret_;
+        blinded_secret_t blinded_secret_;
+        point_codec<typename group_t::domain_t> point_codec_;
+        // blinded_secret_ as sent on the wire
+        byte_view_t wire_blinded_secret_;
+        // Nodes from the own leaf up to the root and the secrets computed for them so far, known once a member id is assigned
+        std::vector<tgdh_node> path_;
+        std::vector<secret_t> path_secrets_;
+        // Blinded keys received so far by node id, they may arrive before the own member id
+        std::unordered_map<node_id_t, blinded_secret_t> blinded_keys_;
+        // Blinded keys of the nodes sponsored by this member, serialized once for retransmissions
+        std::vector<shared_datagram_t> sponsored_blinded_keys_;
+        // Initial sponsor only, the serialized response per assigned member
+        member_id_t next_member_id_;
+        std::unordered_map<boost::asio::ip::udp::endpoint, shared_datagram_t> responses_;
+        std::unordered_set<boost::asio::ip::udp::endpoint> endpoints_acks_rcvd_from_;
+        boost::asio::ip::udp::endpoint sponsor_endpoint_;
+        std::unique_ptr<message_handler<tgdh>> message_handler_;
+        std::uint32_t member_count_;
+        std::unique_ptr<statistics_recorder> statistics_recorder_;
+        std::chrono::milliseconds scatter_delay_;
+        boost::asio::steady_timer scatter_timer_;
+        boost::asio::steady_timer timeout_timer_;
+    // Methods
+    public:
+        tgdh(bool _is_sponsor, service_id_t _service_id, std::uint32_t _member_count, std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max, boost::asio::ip::address _listening_interface_by_ip, boost::asio::ip::address _multicast_ip, std::uint16_t _multicast_port, std::uint32_t _worker_thread_count = 1, std::uint32_t _send_rate = 0, in_memory_bus* _in_memory_bus = nullptr);
+        ~tgdh();
+        void start();
+        virtual void received_data(unsigned char* _data, size_t _bytes_recvd, boost::asio::ip::udp::endpoint _remote_endpoint) override;
+        void process_find(const find_message& _rcvd_find_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_offer(const offer_message& _rcvd_offer_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_request(const request_message& _rcvd_request_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_response(const response_message& _rcvd_response_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_blinded_key(const blinded_key_message& _rcvd_blinded_key_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_finish(const finish_message& _rcvd_finish_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        void process_finish_ack(const finish_ack_message& _rcvd_finish_ack_message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        bool is_relevant(const message_header& _header);
+    protected:
+    private:
+        void assign_member_id(member_id_t _member_id);
+        void store_blinded_key(node_id_t _node_id, byte_view_t _wire_blinded_key);
+        void compute_path_secrets();
+        void send_blinded_key(node_id_t _node_id, const blinded_secret_t& _blinded_key);
+        void check_all_acks_rcvd();
+        void send_cyclic_messages();
+        void send(const message& _message);
+        void send(shared_datagram_t _datagram);
+        void send_to(const message& _message, const boost::asio::ip::udp::endpoint& _remote_endpoint);
+        shared_datagram_t serialize(const message& _message);
+        bool is_assigned();
+        bool all_members_assigned();
+        bool group_secret_computed();
+        std::string short_secret_repr(const secret_t& _secret);
+        void contribute_statistics();
+        void record_transport_statistics();
+        std::chrono::milliseconds compute_scatter_delay(std::uint32_t _scatter_delay_min, std::uint32_t _scatter_delay_max);
+};
+
+#endif
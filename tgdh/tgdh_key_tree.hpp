@@ -0,0 +1,56 @@
+#ifndef TGDH_KEY_TREE
+#define TGDH_KEY_TREE
+
+#include <algorithm>
+#include <vector>
+#include "primitives.hpp"
+
+// Node of the balanced binary key tree over the member ids 1..member_count. Nodes are numbered like a binary heap
+// (root 1, children 2i and 2i+1, so the sibling of node i is i^1) and cover a contiguous range of member ids,
+// the left child the larger half. The first member of a range sponsors the node, i.e. multicasts its blinded key.
+struct tgdh_node {
+    node_id_t node_id_;
+    member_id_t first_member_id_;
+    member_id_t last_member_id_;
+
+    bool is_root() const {
+        return node_id_ == 1;
+    }
+
+    bool is_leaf() const {
+        return first_member_id_ == last_member_id_;
+    }
+
+    bool contains(member_id_t _member_id) const {
+        return first_member_id_ <= _member_id && _member_id <= last_member_id_;
+    }
+
+    tgdh_node left_child() const {
+        return {2 * node_id_, first_member_id_, static_cast<member_id_t>(first_member_id_ + left_child_size() - 1)};
+    }
+
+    tgdh_node right_child() const {
+        return {2 * node_id_ + 1, static_cast<member_id_t>(first_member_id_ + left_child_size()), last_member_id_};
+    }
+
+private:
+    member_id_t left_child_size() const {
+        return (last_member_id_ - first_member_id_ + 2) / 2;
+    }
+};
+
+// Nodes from the leaf of _member_id up to the root, the tree has a depth of ceil(log2(_member_count))
+inline std::vector<tgdh_node> tgdh_path(member_id_t _member_id, member_id_t _member_count) {
+    std::vector<tgdh_node> path;
+    tgdh_node node{1, 1, _member_count};
+    path.push_back(node);
+    while (!node.is_leaf()) {
+        tgdh_node left_child = node.left_child();
+        node = left_child.contains(_member_id) ? left_child : node.right_child();
+        path.push_back(node);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+#endif
@@ -2,16 +2,25 @@
 #define PRIMITIVES
 
 #include <cstdint>
+#include <span>
 
 #define DEFAULT_MEMBER_ID 0
 #define DEFAULT_SERVICE_ID 0
+// Header values of messages not bound to a service or not addressed to a single member. ANY_SERVICE_ID matches every
+// service in message_handler, so it is reserved and rejected as a configured service id
+#define ANY_SERVICE_ID UINT16_MAX
+#define ANY_MEMBER_ID DEFAULT_MEMBER_ID
 #define DEFAULT_SECRET CryptoPP::SecByteBlock()
 #define TIMEOUT 3
 
 typedef uint16_t service_id_t;
 typedef uint16_t member_id_t;
+// Heap index of a node in a key tree, the root is 1
+typedef uint32_t node_id_t;
 typedef uint8_t message_id_t;
 typedef CryptoPP::SecByteBlock blinded_secret_t;
 typedef CryptoPP::SecByteBlock secret_t;
+// Borrowed bytes, e.g. a field of a received datagram
+typedef std::span<const unsigned char> byte_view_t;
 
 #endif
\ No newline at end of file